@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <mongodb/polyvalue.h>
+#include <type_traits>
+
+namespace mqlpath {
+/**
+ * Allocator for containers inside Values. A default constructed allocator binds to the memory
+ * resource of the active mongodb::MemoryResourceScope, so the containers built during an arena
+ * evaluation are carved from the same arena as the Value control blocks.
+ */
+template <typename T>
+class ScopedAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    ScopedAllocator() noexcept : _resource(mongodb::currentMemoryResource()) {}
+
+    template <typename U>
+    ScopedAllocator(const ScopedAllocator<U>& other) noexcept : _resource(other.resource()) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(_resource->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* ptr, std::size_t n) noexcept {
+        _resource->deallocate(ptr, n * sizeof(T), alignof(T));
+    }
+
+    /**
+     * Copies of a container are allocated from the current scope, not from the source's resource.
+     */
+    ScopedAllocator select_on_container_copy_construction() const noexcept {
+        return ScopedAllocator{};
+    }
+
+    std::pmr::memory_resource* resource() const noexcept {
+        return _resource;
+    }
+
+    template <typename U>
+    bool operator==(const ScopedAllocator<U>& other) const noexcept {
+        return _resource == other.resource();
+    }
+
+private:
+    std::pmr::memory_resource* _resource;
+};
+}  // namespace mqlpath
@@ -41,7 +41,7 @@ struct ConstantValue {
     ConstantValue(Value value, location location) : value(value), location(location) {}
     ConstantValue(Scalar scalar, location location)
         : value(Value::make<ScalarValue>(scalar)), location(location) {}
-    ConstantValue(std::vector<Value> array, location location)
+    ConstantValue(Array array, location location)
         : value(Value::make<ArrayValue>(std::move(array))), location(location) {}
 
     bool operator==(const ConstantValue& other) const {
@@ -94,15 +94,15 @@ struct LambdaPath {
 };
 
 struct DropPath {
-    explicit DropPath(std::vector<std::string> fieldNames) : fieldNames(std::move(fieldNames)) {}
+    explicit DropPath(std::vector<FieldName> fieldNames) : fieldNames(std::move(fieldNames)) {}
     bool operator==(const DropPath&) const = default;
-    std::vector<std::string> fieldNames;
+    std::vector<FieldName> fieldNames;
 };
 
 struct KeepPath {
-    explicit KeepPath(std::vector<std::string> fieldNames) : fieldNames(std::move(fieldNames)) {}
+    explicit KeepPath(std::vector<FieldName> fieldNames) : fieldNames(std::move(fieldNames)) {}
     bool operator==(const KeepPath&) const = default;
-    std::vector<std::string> fieldNames;
+    std::vector<FieldName> fieldNames;
 };
 
 struct ObjPath {
@@ -114,18 +114,18 @@ struct ArrPath {
 };
 
 struct FieldPath {
-    FieldPath(std::string fieldName, Path path)
+    FieldPath(FieldName fieldName, Path path)
         : fieldName(std::move(fieldName)), path(std::move(path)) {}
     bool operator==(const FieldPath&) const = default;
-    std::string fieldName;
+    FieldName fieldName;
     Path path;
 };
 
 struct GetPath {
-    GetPath(std::string fieldName, Path path)
+    GetPath(FieldName fieldName, Path path)
         : fieldName(std::move(fieldName)), path(std::move(path)) {}
     bool operator==(const GetPath&) const = default;
-    std::string fieldName;
+    FieldName fieldName;
     Path path;
 };
 
@@ -1,6 +1,7 @@
 #include "mqlpath/ast_eval.h"
 #include "mqlpath/ast.h"
 #include "mqlpath/value.h"
+#include <utility>
 
 namespace mqlpath {
 namespace {
@@ -56,24 +57,31 @@ struct PathEval {
     }
 
     Value operator()(const Path&, const FieldPath& path, Value value) {
-        auto innerValue = Value::make<NothingValue>();
-        Object object{};
-        if (isObject(value)) {
-            object = std::move(value.cast<ObjectValue>()->object);
-            innerValue = object.getValue(path.fieldName);
-        }
-        innerValue = path.path.visit(*this, std::move(innerValue));
-        if (isObject(value) || !isNothing(innerValue)) {
+        if (!isObject(value)) {
+            auto innerValue = path.path.visit(*this, Value::make<NothingValue>());
+            if (isNothing(innerValue)) {
+                return value;
+            }
+            Object object{};
             object.setValue(path.fieldName, std::move(innerValue));
             return Value::make<ObjectValue>(std::move(object));
         }
+
+        // Update the object in place, cloning it first only if it is shared. Moving the field out
+        // of it leaves the inner path the only owner of the field, so it can do the same.
+        auto& object = value.cast<ObjectValue>()->object;
+        size_t position = Object::npos;
+        auto innerValue = object.releaseValue(path.fieldName, position);
+        object.restoreValue(
+            path.fieldName, position, path.path.visit(*this, std::move(innerValue)));
         return value;
     }
 
     Value operator()(const Path&, const GetPath& path, Value value) {
         auto innerValue = Value::make<NothingValue>();
         if (isObject(value)) {
-            auto objectValue = value.cast<ObjectValue>();
+            // Read through a const Value to share the field instead of cloning the object.
+            auto objectValue = std::as_const(value).cast<ObjectValue>();
             innerValue = objectValue->object.getValue(path.fieldName);
         }
         return path.path.visit(*this, std::move(innerValue));
@@ -82,9 +90,9 @@ struct PathEval {
     Value operator()(const Path&, const AtPath& path, Value value) {
         auto innerValue = Value::make<NothingValue>();
         if (isArray(value)) {
-            auto arrayValue = value.cast<ArrayValue>();
+            auto arrayValue = std::as_const(value).cast<ArrayValue>();
             if (arrayValue->array.size() > static_cast<size_t>(path.index)) {
-                innerValue = std::move(arrayValue->array[path.index]);
+                innerValue = arrayValue->array[path.index];
             }
         }
         return path.path.visit(*this, std::move(innerValue));
@@ -96,7 +104,7 @@ struct PathEval {
         }
 
         auto arrayValue = value.cast<ArrayValue>();
-        std::vector<Value> values{};
+        Array values{};
         values.reserve(arrayValue->array.size());
 
         for (auto&& element : arrayValue->array) {
@@ -121,6 +129,85 @@ struct PathEval {
     }
 };
 
+// Shared by the borrowed results of paths which reach no value.
+const Value kNothing = Value::make<NothingValue>();
+
+/**
+ * PathEval over borrowed values.
+ */
+struct BorrowedPathEval {
+    BorrowedValue operator()(const Path&, const IdPath&, const BorrowedValue& input) {
+        return input;
+    }
+
+    BorrowedValue operator()(const Path&, const DefaultPath& path, const BorrowedValue& input) {
+        if (isNothing(input.get())) {
+            return BorrowedValue{evaluate(path.expr)};
+        }
+        return input;
+    }
+
+    BorrowedValue operator()(const Path&, const ObjPath&, const BorrowedValue& input) {
+        return isObject(input.get()) ? input : BorrowedValue{kNothing};
+    }
+
+    BorrowedValue operator()(const Path&, const ArrPath&, const BorrowedValue& input) {
+        return isArray(input.get()) ? input : BorrowedValue{kNothing};
+    }
+
+    BorrowedValue operator()(const Path&, const GetPath& path, const BorrowedValue& input) {
+        const Value& value = input.get();
+        if (isObject(value)) {
+            if (auto field = value.cast<ObjectValue>()->object.findValue(path.fieldName)) {
+                return path.path.visit(*this, input.borrow(*field));
+            }
+        }
+        return path.path.visit(*this, BorrowedValue{kNothing});
+    }
+
+    BorrowedValue operator()(const Path&, const AtPath& path, const BorrowedValue& input) {
+        const Value& value = input.get();
+        if (isArray(value)) {
+            const auto& array = value.cast<ArrayValue>()->array;
+            if (array.size() > static_cast<size_t>(path.index)) {
+                return path.path.visit(*this, input.borrow(array[path.index]));
+            }
+        }
+        return path.path.visit(*this, BorrowedValue{kNothing});
+    }
+
+    BorrowedValue operator()(const Path& p, const TraversePath& path, const BorrowedValue& input) {
+        const Value& value = input.get();
+        if (!isArray(value)) {
+            return path.path.visit(*this, input);
+        }
+
+        const auto& array = value.cast<ArrayValue>()->array;
+        Array values{};
+        values.reserve(array.size());
+        for (const auto& element : array) {
+            auto outValue = (isArray(element) ? p : path.path).visit(*this, input.borrow(element));
+            if (!isNothing(outValue.get())) {
+                values.emplace_back(outValue.copyOut());
+            }
+        }
+        return BorrowedValue{Value::make<ArrayValue>(std::move(values))};
+    }
+
+    BorrowedValue operator()(const Path&, const CompositionPath& path, const BorrowedValue& input) {
+        return path.right.visit(*this, path.left.visit(*this, input));
+    }
+
+    /**
+     * Const, Lambda and the steps which modify their input.
+     */
+    template <typename T>
+    BorrowedValue operator()(const Path& p, const T&, const BorrowedValue& input) {
+        PathEval eval{};
+        return BorrowedValue{p.visit(eval, input.copyOut())};
+    }
+};
+
 struct ExpressionEval {
     Value operator()(const Expression&, const ConstantValue& expr) {
         return expr.value;
@@ -129,7 +216,7 @@ struct ExpressionEval {
     Value operator()(const Expression&, const EvalPath& expr) {
         auto value = expr.expr.visit(*this);
         PathEval eval{};
-        return expr.path.visit(eval, value);
+        return expr.path.visit(eval, std::move(value));
     }
 };
 
@@ -139,4 +226,21 @@ Value evaluate(const Expression& expr) {
     ExpressionEval eval{};
     return expr.visit(eval);
 }
+
+Value evaluate(const Path& path, Value input) {
+    PathEval eval{};
+    return path.visit(eval, std::move(input));
+}
+
+BorrowedValue evaluateBorrowed(const Path& path, const Value& input) {
+    BorrowedPathEval eval{};
+    return path.visit(eval, BorrowedValue{input});
+}
+
+ArenaValue evaluate(const Expression& expr, std::pmr::memory_resource* upstream) {
+    auto arena = std::make_unique<std::pmr::monotonic_buffer_resource>(upstream);
+    mongodb::MemoryResourceScope scope{arena.get()};
+    auto value = evaluate(expr);
+    return ArenaValue{std::move(arena), std::move(value)};
+}
 }  // namespace mqlpath
\ No newline at end of file
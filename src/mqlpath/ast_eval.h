@@ -1,7 +1,92 @@
 #pragma once
 
 #include "mqlpath/ast.h"
+#include <memory>
+#include <memory_resource>
+#include <utility>
 
 namespace mqlpath {
 Value evaluate(const Expression& expr);
-}
\ No newline at end of file
+
+/**
+ * Evaluates the path over the given input value.
+ */
+Value evaluate(const Path& path, Value input);
+
+/**
+ * Result of a borrowed evaluation: either a view of a value inside the evaluated document, or a
+ * value the evaluation had to build, together with whatever the view points into. A view must not
+ * outlive the document; use copyOut() to obtain a Value which may, sharing the data instead of
+ * cloning it.
+ */
+class BorrowedValue {
+public:
+    /**
+     * Borrows 'value', which must outlive the result.
+     */
+    explicit BorrowedValue(const Value& value) : _value(&value) {}
+
+    explicit BorrowedValue(Value&& value) : _owner(std::move(value)) {}
+
+    /**
+     * Borrows 'value', which lies inside 'owner'. Holding the owner keeps it alive.
+     */
+    BorrowedValue(const Value& value, Value owner) : _value(&value), _owner(std::move(owner)) {}
+
+    const Value& get() const {
+        return _value != nullptr ? *_value : _owner;
+    }
+
+    Value copyOut() const {
+        return get();
+    }
+
+    /**
+     * Borrows 'value', which lies inside the value of this result.
+     */
+    BorrowedValue borrow(const Value& value) const {
+        return _owner.empty() ? BorrowedValue{value} : BorrowedValue{value, _owner};
+    }
+
+private:
+    const Value* _value{nullptr};
+    Value _owner;
+};
+
+/**
+ * Evaluates the path over a borrowed document without copying it. Id, Get, At, Obj, Arr and
+ * Default return a view of the value they reach, so a path made only of them neither allocates
+ * nor touches a reference count. Traverse builds a new array of the results of its elements. The
+ * other steps take a shared copy of their input and are evaluated as by evaluate().
+ */
+BorrowedValue evaluateBorrowed(const Path& path, const Value& input);
+
+/**
+ * Result of an evaluation whose Values were allocated from an arena. The arena is released in one
+ * step together with the result, so the value must not outlive it: use copyOut() to obtain a Value
+ * that does. Neither the result nor the values it holds may be used concurrently.
+ */
+class ArenaValue {
+public:
+    ArenaValue(std::unique_ptr<std::pmr::monotonic_buffer_resource> arena, Value value)
+        : _arena(std::move(arena)), _value(std::move(value)) {}
+
+    const Value& get() const {
+        return _value;
+    }
+
+    Value copyOut() const {
+        return copyOutOf(_value, _arena.get());
+    }
+
+private:
+    // Declared before the value so that the value is destroyed first.
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> _arena;
+    Value _value;
+};
+
+/**
+ * Evaluates the expression allocating all new Values from an arena on top of 'upstream'.
+ */
+ArenaValue evaluate(const Expression& expr, std::pmr::memory_resource* upstream);
+}  // namespace mqlpath
@@ -2,8 +2,33 @@
 #include "mqlpath/ast_make.h"
 #include "mqlpath/value.h"
 #include <catch2/catch_test_macros.hpp>
+#include <memory_resource>
+#include <utility>
 
 namespace mqlpath {
+namespace {
+class CountingResource : public std::pmr::memory_resource {
+public:
+    size_t allocated{0};
+    size_t deallocated{0};
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        allocated += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+        deallocated += bytes;
+        std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+}  // namespace
+
 TEST_CASE("object value", "[eval]") {
     Value value = ast::value(Object{{
         {"hello", ast::value(5)},
@@ -321,6 +346,22 @@ TEST_CASE("EvalPath (Field a Const 7) {b:7} => {b:7, a:7}", "[eval]") {
     REQUIRE(ast::value(expected) == actualValue);
 }
 
+TEST_CASE("EvalPath (Field a Const Nothing) {a:1, b:2, a:3} => {b:2}", "[eval]") {
+    // Parsed documents may repeat a name, and Nothing removes every field of that name.
+    Object object{{
+        {"a", ast::value(1)},
+        {"b", ast::value(2)},
+        {"a", ast::value(3)},
+    }};
+    Object expected{{
+        {"b", ast::value(2)},
+    }};
+    auto path = ast::field("a", ast::constPath(ast::nothing()));
+    REQUIRE(ast::value(expected) == evaluate(ast::evalPath(path, ast::value(object))));
+    REQUIRE(ast::value(expected) == evaluate(path, ast::value(object)));
+    REQUIRE(evaluate(ast::drop({"a"}), ast::value(object)) == ast::value(expected));
+}
+
 // EvalPath Get
 
 TEST_CASE("EvalPath (Get a Id) 5 => Nothing", "[eval]") {
@@ -515,4 +556,148 @@ TEST_CASE(
     auto actualValue = evaluate(expr);
     REQUIRE(ast::value(expected) == actualValue);
 }
-}  // namespace mqlpath
\ No newline at end of file
+
+// Arena evaluation
+
+TEST_CASE("EvalPath in arena allocates from the upstream resource", "[eval]") {
+    Object object{{{"a", ast::value(std::vector<int32_t>{1, 2, 3})}}};
+    Object expected{{{"a", ast::value(std::vector<int32_t>{7, 7, 7})}}};
+    auto expr = ast::evalPath(ast::field("a", ast::traverse(ast::constPath(7))), object);
+
+    CountingResource upstream{};
+    {
+        auto result = evaluate(expr, &upstream);
+        REQUIRE(ast::value(expected) == result.get());
+        REQUIRE(upstream.allocated > 0);
+        REQUIRE(upstream.deallocated == 0);
+    }
+    REQUIRE(upstream.deallocated == upstream.allocated);
+}
+
+TEST_CASE("EvalPath in arena result copied out outlives the arena", "[eval]") {
+    Object object{{{"a", ast::value(std::vector<int32_t>{1, 2, 3})}, {"b", ast::value(5)}}};
+    Object expected{{{"a", ast::value(std::vector<int32_t>{7, 7, 7})}, {"b", ast::value(5)}}};
+    auto expr = ast::evalPath(ast::field("a", ast::traverse(ast::constPath(7))), object);
+
+    CountingResource upstream{};
+    Value value{};
+    {
+        auto result = evaluate(expr, &upstream);
+        value = result.copyOut();
+    }
+    REQUIRE(upstream.deallocated == upstream.allocated);
+    REQUIRE(value.getResource() == std::pmr::new_delete_resource());
+    REQUIRE(ast::value(expected) == value);
+}
+
+// Borrowed evaluation
+
+TEST_CASE("Borrowed evaluation of read-only paths returns views of the input", "[eval]") {
+    const auto document = ast::value(Object{{
+        {"a", ast::value(Object{{{"b", ast::value(std::vector<int32_t>{1, 2, 3})}}})},
+        {"c", ast::value("text")},
+    }});
+    const auto& a = document.cast<ObjectValue>()->object.getValues()[0];
+    const auto& b = a.cast<ObjectValue>()->object.getValues()[0];
+    auto getArray = ast::get("a", ast::get("b", ast::arr()));
+    auto getElement = ast::get("a", ast::get("b", ast::at(2, ast::id())));
+    auto getObject = ast::compose(ast::get("a", ast::obj()), ast::id());
+    auto getMissing = ast::get("a", ast::get("x", ast::id()));
+
+    CountingResource resource{};
+    mongodb::MemoryResourceScope scope{&resource};
+    REQUIRE(&evaluateBorrowed(getArray, document).get() == &b);
+    REQUIRE(&evaluateBorrowed(getElement, document).get() == &b.cast<ArrayValue>()->array[2]);
+    REQUIRE(&evaluateBorrowed(getObject, document).get() == &a);
+    REQUIRE(isNothing(evaluateBorrowed(getMissing, document).get()));
+    REQUIRE(resource.allocated == 0);
+    REQUIRE(!a.isShared());
+}
+
+TEST_CASE("Borrowed evaluation matches evaluation", "[eval]") {
+    auto document = ast::value(Object{{
+        {"a", ast::value(Object{{{"b", ast::value(1)}, {"c", ast::value(2)}}})},
+        {"items",
+         Value::make<ArrayValue>(std::vector<Value>{
+             ast::value(Object{{{"b", ast::value(3)}}}),
+             Value::make<ArrayValue>(
+                 std::vector<Value>{ast::value(Object{{{"b", ast::value(4)}}})}),
+             ast::value(5),
+         })},
+    }});
+    auto copy = document;
+
+    std::vector<Path> paths{
+        ast::id(),
+        ast::get("a", ast::get("b", ast::id())),
+        ast::get("items", ast::at(1, ast::at(0, ast::id()))),
+        ast::get("items", ast::traverse(ast::get("b", ast::id()))),
+        ast::compose(ast::get("items", ast::traverse(ast::obj())), ast::at(1, ast::id())),
+        ast::get("missing", ast::defaultPath(7)),
+        ast::get("missing", ast::constPath(8)),
+        ast::compose(ast::get("a", ast::id()), ast::drop({"b"})),
+        ast::compose(ast::field("a", ast::constPath(9)), ast::get("a", ast::id())),
+    };
+    for (const auto& path : paths) {
+        auto result = evaluateBorrowed(path, document);
+        REQUIRE(evaluate(path, document) == result.get());
+        REQUIRE(evaluate(path, document) == result.copyOut());
+    }
+    REQUIRE(copy == document);
+}
+
+TEST_CASE("Borrowed evaluation result copied out outlives the input", "[eval]") {
+    Value value{};
+    {
+        auto items = Value::make<ArrayValue>(
+            std::vector<Value>{ast::value(Object{{{"b", ast::value(1)}}})});
+        auto document = ast::value(Object{{{"items", std::move(items)}}});
+        auto path =
+            ast::compose(ast::get("items", ast::traverse(ast::id())), ast::at(0, ast::id()));
+        value = evaluateBorrowed(path, document).copyOut();
+    }
+    REQUIRE(ast::value(Object{{{"b", ast::value(1)}}}) == value);
+}
+
+// In-place updates
+
+TEST_CASE("Field updates an owned document in place", "[eval]") {
+    auto b = ast::value(Object{{{"x", ast::value(1)}, {"y", ast::value(2)}}});
+    auto document = ast::value(Object{{
+        {"a", ast::value(Object{{{"b", std::move(b)}}})},
+        {"c", ast::value(3)},
+    }});
+    const auto* object = &std::as_const(document).cast<ObjectValue>()->object;
+    const auto* a = object->findValue("a")->cast<ObjectValue>();
+    auto path = ast::field("a", ast::field("b", ast::drop({"x"})));
+
+    CountingResource resource{};
+    mongodb::MemoryResourceScope scope{&resource};
+    auto result = evaluate(path, std::move(document));
+    REQUIRE(resource.allocated == 0);
+    REQUIRE(&std::as_const(result).cast<ObjectValue>()->object == object);
+    REQUIRE(object->findValue("a")->cast<ObjectValue>() == a);
+    REQUIRE(ast::value(Object{{
+                {"a", ast::value(Object{{{"b", ast::value(Object{{{"y", ast::value(2)}}})}}})},
+                {"c", ast::value(3)},
+            }}) == result);
+}
+
+TEST_CASE("Field copies only the updated path of a shared document", "[eval]") {
+    auto document = ast::value(Object{{
+        {"a", ast::value(Object{{{"b", ast::value(1)}}})},
+        {"c", ast::value(Object{{{"d", ast::value(2)}}})},
+    }});
+    auto copy = document;
+
+    auto result = evaluate(ast::field("a", ast::field("b", ast::constPath(5))), copy);
+    REQUIRE(ast::value(Object{{
+                {"a", ast::value(Object{{{"b", ast::value(5)}}})},
+                {"c", ast::value(Object{{{"d", ast::value(2)}}})},
+            }}) == result);
+    REQUIRE(ast::value(1) == evaluate(ast::get("a", ast::get("b", ast::id())), document));
+
+    const auto& c = *std::as_const(document).cast<ObjectValue>()->object.findValue("c");
+    REQUIRE(c.isShared());
+}
+}  // namespace mqlpath
@@ -17,7 +17,7 @@ inline Value value(T val) {
 
 template <scalar T>
 Value value(std::vector<T> array) {
-    std::vector<Value> valueArray{};
+    Array valueArray{};
     valueArray.reserve(array.size());
 
     std::transform(begin(array), end(array), std::back_inserter(valueArray), [](const T& v) {
@@ -85,11 +85,11 @@ inline Path lambda(T val) {
     return Path::make<LambdaPath>(expr(std::move(val)));
 }
 
-inline Path drop(std::vector<std::string> fieldNames) {
+inline Path drop(std::vector<FieldName> fieldNames) {
     return Path::make<DropPath>(std::move(fieldNames));
 }
 
-inline Path keep(std::vector<std::string> fieldNames) {
+inline Path keep(std::vector<FieldName> fieldNames) {
     return Path::make<KeepPath>(std::move(fieldNames));
 }
 
@@ -101,11 +101,11 @@ inline Path arr() {
     return Path::make<ArrPath>();
 }
 
-inline Path field(std::string fieldName, Path path) {
+inline Path field(FieldName fieldName, Path path) {
     return Path::make<FieldPath>(std::move(fieldName), std::move(path));
 }
 
-inline Path get(std::string fieldName, Path path) {
+inline Path get(FieldName fieldName, Path path) {
     return Path::make<GetPath>(std::move(fieldName), std::move(path));
 }
 
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace mqlpath {
+/**
+ * Blocking queue of at most 'capacity' items connecting the threads of two pipeline stages. A
+ * full queue blocks its producers and an empty one its consumers, so a slow stage throttles the
+ * ones before it instead of letting items pile up. Once closed, push() drops its item and pop()
+ * drains the remaining items before it returns nullopt.
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : _capacity(capacity == 0 ? 1 : capacity) {}
+
+    /**
+     * Waits for room and appends the item. Returns false if the queue was closed.
+     */
+    bool push(T item) {
+        {
+            std::unique_lock lock{_mutex};
+            _notFull.wait(lock, [this] { return _closed || _items.size() < _capacity; });
+            if (_closed) {
+                return false;
+            }
+            _items.push_back(std::move(item));
+        }
+        _notEmpty.notify_one();
+        return true;
+    }
+
+    /**
+     * Waits for an item and removes it. Returns nullopt once the queue is closed and empty.
+     */
+    std::optional<T> pop() {
+        std::optional<T> item;
+        {
+            std::unique_lock lock{_mutex};
+            _notEmpty.wait(lock, [this] { return _closed || !_items.empty(); });
+            if (_items.empty()) {
+                return std::nullopt;
+            }
+            item.emplace(std::move(_items.front()));
+            _items.pop_front();
+        }
+        _notFull.notify_one();
+        return item;
+    }
+
+    /**
+     * Wakes all waiting threads. Further pushes fail, pops return the remaining items.
+     */
+    void close() {
+        {
+            std::lock_guard lock{_mutex};
+            _closed = true;
+        }
+        _notFull.notify_all();
+        _notEmpty.notify_all();
+    }
+
+private:
+    const size_t _capacity;
+    std::mutex _mutex;
+    std::condition_variable _notFull;
+    std::condition_variable _notEmpty;
+    std::deque<T> _items;
+    bool _closed{false};
+};
+}  // namespace mqlpath
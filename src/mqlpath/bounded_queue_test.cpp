@@ -0,0 +1,48 @@
+#include "mqlpath/bounded_queue.h"
+#include <catch2/catch_test_macros.hpp>
+#include <thread>
+#include <vector>
+
+namespace mqlpath {
+TEST_CASE("bounded queue passes items in order", "[bounded_queue]") {
+    BoundedQueue<int> queue{2};
+    std::vector<int> received{};
+    std::thread consumer{[&] {
+        while (auto item = queue.pop()) {
+            received.push_back(*item);
+        }
+    }};
+    for (int item = 0; item < 1000; ++item) {
+        REQUIRE(queue.push(item));
+    }
+    queue.close();
+    consumer.join();
+
+    REQUIRE(received.size() == 1000);
+    for (int item = 0; item < 1000; ++item) {
+        REQUIRE(received[item] == item);
+    }
+}
+
+TEST_CASE("closed bounded queue drains and rejects pushes", "[bounded_queue]") {
+    BoundedQueue<int> queue{4};
+    REQUIRE(queue.push(1));
+    REQUIRE(queue.push(2));
+    queue.close();
+
+    REQUIRE(!queue.push(3));
+    REQUIRE(queue.pop() == 1);
+    REQUIRE(queue.pop() == 2);
+    REQUIRE(!queue.pop().has_value());
+}
+
+TEST_CASE("closing a full bounded queue releases its producer", "[bounded_queue]") {
+    BoundedQueue<int> queue{1};
+    REQUIRE(queue.push(1));
+    bool pushed = true;
+    std::thread producer{[&] { pushed = queue.push(2); }};
+    queue.close();
+    producer.join();
+    REQUIRE(!pushed);
+}
+}  // namespace mqlpath
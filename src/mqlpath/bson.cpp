@@ -0,0 +1,355 @@
+#include "mqlpath/bson.h"
+#include <bit>
+#include <charconv>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+namespace mqlpath {
+namespace {
+static_assert(std::endian::native == std::endian::little, "BSON is read and written in place");
+
+int32_t readInt32(const uint8_t* data) {
+    int32_t result;
+    std::memcpy(&result, data, sizeof(result));
+    return result;
+}
+
+[[noreturn]] void throwMalformed() {
+    throw std::invalid_argument("malformed BSON");
+}
+
+/**
+ * Size of the value of the given type starting at 'data', checked against 'end'.
+ */
+size_t valueSize(uint8_t type, const uint8_t* data, const uint8_t* end) {
+    const size_t available = end - data;
+    auto requireAvailable = [available](size_t size) {
+        if (size > available) {
+            throwMalformed();
+        }
+        return size;
+    };
+
+    switch (type) {
+        case 0x06:  // undefined
+        case 0x0A:  // null
+        case 0x7F:  // max key
+        case 0xFF:  // min key
+            return 0;
+        case 0x08:  // bool
+            return requireAvailable(1);
+        case 0x10:  // int32
+            return requireAvailable(4);
+        case 0x01:  // double
+        case 0x09:  // UTC datetime
+        case 0x11:  // timestamp
+        case 0x12:  // int64
+            return requireAvailable(8);
+        case 0x07:  // ObjectId
+            return requireAvailable(12);
+        case 0x13:  // decimal128
+            return requireAvailable(16);
+        case 0x02:  // string
+        case 0x0D:  // JavaScript code
+        case 0x0E: {  // symbol
+            requireAvailable(4);
+            const int32_t length = readInt32(data);
+            if (length < 1) {
+                throwMalformed();
+            }
+            return requireAvailable(4 + static_cast<size_t>(length));
+        }
+        case 0x03:  // document
+        case 0x04: {  // array
+            requireAvailable(4);
+            const int32_t size = readInt32(data);
+            if (size < 5 || data[requireAvailable(size) - 1] != 0) {
+                throwMalformed();
+            }
+            return size;
+        }
+        case 0x05: {  // binary
+            requireAvailable(4);
+            const int32_t length = readInt32(data);
+            if (length < 0) {
+                throwMalformed();
+            }
+            return requireAvailable(5 + static_cast<size_t>(length));
+        }
+        case 0x0B: {  // regular expression: pattern and options as two C strings
+            auto pattern = static_cast<const uint8_t*>(std::memchr(data, 0, available));
+            auto options = pattern != nullptr
+                ? static_cast<const uint8_t*>(std::memchr(pattern + 1, 0, end - pattern - 1))
+                : nullptr;
+            if (options == nullptr) {
+                throwMalformed();
+            }
+            return options + 1 - data;
+        }
+        default:
+            throw std::invalid_argument("unsupported BSON type " + std::to_string(type));
+    }
+}
+
+/**
+ * Appends BSON to a byte vector. A document's size is written as a placeholder and patched once
+ * its last element is written, so every value is visited once. Each element is written with a
+ * single extension of the buffer for its type, name and fixed-size payload.
+ */
+class BsonWriter {
+public:
+    explicit BsonWriter(std::vector<uint8_t>& bytes) : _bytes(bytes) {}
+
+    void writeDocument(const Object& object) {
+        const size_t start = beginDocument();
+        const auto& names = object.getNames();
+        const auto& values = object.getValues();
+        for (size_t position = 0; position < names.size(); ++position) {
+            values[position].visit(*this, std::string_view{names[position].str()});
+        }
+        endDocument(start);
+    }
+
+    void operator()(const Value&, const NothingValue&, std::string_view name) {
+        writeHeader(0x06, name, 0);
+    }
+
+    void operator()(const Value&, const ScalarValue& scalar, std::string_view name) {
+        if (auto boolValue = std::get_if<bool>(&scalar.scalar); boolValue != nullptr) {
+            *writeHeader(0x08, name, 1) = *boolValue ? 1 : 0;
+        } else if (auto int32Value = std::get_if<int32_t>(&scalar.scalar); int32Value != nullptr) {
+            std::memcpy(writeHeader(0x10, name, sizeof(int32_t)), int32Value, sizeof(int32_t));
+        } else if (auto doubleValue = std::get_if<double>(&scalar.scalar); doubleValue != nullptr) {
+            std::memcpy(writeHeader(0x01, name, sizeof(double)), doubleValue, sizeof(double));
+        } else {
+            const auto& string = std::get<std::string>(scalar.scalar);
+            const auto length = static_cast<int32_t>(string.size() + 1);
+            auto data = writeHeader(0x02, name, sizeof(length) + string.size() + 1);
+            std::memcpy(data, &length, sizeof(length));
+            std::memcpy(data + sizeof(length), string.data(), string.size());
+            data[sizeof(length) + string.size()] = 0;
+        }
+    }
+
+    void operator()(const Value&, const ArrayValue& array, std::string_view name) {
+        writeHeader(0x04, name, 0);
+        const size_t start = beginDocument();
+        char key[24];
+        for (size_t index = 0; index < array.array.size(); ++index) {
+            auto keyEnd = std::to_chars(key, key + sizeof(key), index).ptr;
+            const std::string_view keyView{key, static_cast<size_t>(keyEnd - key)};
+            array.array[index].visit(*this, keyView);
+        }
+        endDocument(start);
+    }
+
+    void operator()(const Value&, const ObjectValue& object, std::string_view name) {
+        writeHeader(0x03, name, 0);
+        writeDocument(object.object);
+    }
+
+private:
+    /**
+     * Writes the type and the name of an element and reserves 'payloadSize' bytes after them.
+     * Returns the position of the payload.
+     */
+    uint8_t* writeHeader(uint8_t type, std::string_view name, size_t payloadSize) {
+        auto data = extend(1 + name.size() + 1 + payloadSize);
+        data[0] = type;
+        std::memcpy(data + 1, name.data(), name.size());
+        data[1 + name.size()] = 0;
+        return data + 1 + name.size() + 1;
+    }
+
+    size_t beginDocument() {
+        const size_t start = _bytes.size();
+        extend(sizeof(int32_t));
+        return start;
+    }
+
+    void endDocument(size_t start) {
+        _bytes.push_back(0);
+        const auto size = static_cast<int32_t>(_bytes.size() - start);
+        std::memcpy(_bytes.data() + start, &size, sizeof(size));
+    }
+
+    uint8_t* extend(size_t size) {
+        const size_t position = _bytes.size();
+        _bytes.resize(position + size);
+        return _bytes.data() + position;
+    }
+
+    std::vector<uint8_t>& _bytes;
+};
+}  // namespace
+
+BsonView BsonView::document(std::span<const uint8_t> bytes) {
+    if (bytes.size() < 5 || readInt32(bytes.data()) != static_cast<int32_t>(bytes.size()) ||
+        bytes.back() != 0) {
+        throwMalformed();
+    }
+    return BsonView{static_cast<uint8_t>(Type::Document), bytes.data()};
+}
+
+const uint8_t* BsonView::readElement(const uint8_t* element,
+                                     const uint8_t* end,
+                                     std::string_view& name,
+                                     BsonView& value) {
+    const uint8_t type = *element++;
+    auto nameEnd = static_cast<const uint8_t*>(std::memchr(element, 0, end - element));
+    if (nameEnd == nullptr) {
+        throwMalformed();
+    }
+    name = std::string_view{reinterpret_cast<const char*>(element),
+                            static_cast<size_t>(nameEnd - element)};
+    const uint8_t* data = nameEnd + 1;
+    value = BsonView{type, data};
+    return data + valueSize(type, data, end);
+}
+
+BsonView BsonView::getField(const FieldName& fieldName) const {
+    if (!isDocument()) {
+        return {};
+    }
+
+    const std::string_view target = fieldName.str();
+    const uint8_t* end = _data + readInt32(_data) - 1;
+    for (const uint8_t* element = _data + 4; element < end;) {
+        std::string_view name;
+        BsonView value;
+        element = readElement(element, end, name, value);
+        if (name == target) {
+            return value;
+        }
+    }
+    return {};
+}
+
+BsonView BsonView::getElement(size_t index) const {
+    if (!isArray()) {
+        return {};
+    }
+
+    const uint8_t* end = _data + readInt32(_data) - 1;
+    for (const uint8_t* element = _data + 4; element < end; --index) {
+        std::string_view name;
+        BsonView value;
+        element = readElement(element, end, name, value);
+        if (index == 0) {
+            return value;
+        }
+    }
+    return {};
+}
+
+/**
+ * Converts BSON views into Values. The fields and elements of all nesting levels are collected on
+ * two stacks reused across the conversion, so every object and array is built with storage of
+ * its exact size instead of growing its own vector.
+ */
+class BsonView::ValueConverter {
+public:
+    Value convert(BsonView view, const FieldSet& projection) {
+        switch (view.getType()) {
+            case Type::Document: {
+                const size_t first = _fields.size();
+                view.forEach([&](std::string_view name, BsonView value) {
+                    if (value.isNothing()) {
+                        return;
+                    }
+                    auto fieldName = _names.get(name);
+                    if (const auto& fieldProjection = projection.getField(fieldName);
+                        !fieldProjection.isEmpty()) {
+                        _fields.emplace_back(fieldName, convert(value, fieldProjection));
+                    }
+                });
+                Object::Fields fields{};
+                fields.reserve(_fields.size() - first);
+                fields.insert(fields.end(),
+                              std::make_move_iterator(_fields.begin() + first),
+                              std::make_move_iterator(_fields.end()));
+                _fields.resize(first);
+                return Value::make<ObjectValue>(Object{std::move(fields)});
+            }
+            case Type::Array: {
+                const auto& elementProjection = projection.getElements();
+                if (elementProjection.isEmpty()) {
+                    return Value::make<ArrayValue>(Array{});
+                }
+                const size_t first = _elements.size();
+                view.forEach([&](std::string_view, BsonView value) {
+                    _elements.emplace_back(convert(value, elementProjection));
+                });
+                Array elements{};
+                elements.reserve(_elements.size() - first);
+                elements.insert(elements.end(),
+                                std::make_move_iterator(_elements.begin() + first),
+                                std::make_move_iterator(_elements.end()));
+                _elements.resize(first);
+                return Value::make<ArrayValue>(std::move(elements));
+            }
+            default:
+                return convertScalar(view);
+        }
+    }
+
+private:
+    static Value convertScalar(BsonView view) {
+        const uint8_t* data = view._data;
+        switch (view.getType()) {
+            case Type::Double: {
+                double result;
+                std::memcpy(&result, data, sizeof(result));
+                return Value::make<ScalarValue>(Scalar{result});
+            }
+            case Type::String: {
+                const int32_t length = readInt32(data);
+                return Value::make<ScalarValue>(
+                    Scalar{std::string{reinterpret_cast<const char*>(data + 4),
+                                       static_cast<size_t>(length - 1)}});
+            }
+            case Type::Bool:
+                return Value::make<ScalarValue>(Scalar{*data != 0});
+            case Type::Int32:
+                return Value::make<ScalarValue>(Scalar{readInt32(data)});
+            default:
+                if (view.isNothing()) {
+                    return Value::make<NothingValue>();
+                }
+                throw std::invalid_argument("unsupported BSON type " + std::to_string(view._type));
+        }
+    }
+
+    std::vector<Object::Field> _fields;
+    std::vector<Value> _elements;
+    FieldNameCache _names;
+};
+
+Value BsonView::toValue() const {
+    return toValue(FieldSet::all());
+}
+
+Value BsonView::toValue(const FieldSet& projection) const {
+    ValueConverter converter{};
+    return converter.convert(*this, projection.isEmpty() ? FieldSet::shape() : projection);
+}
+
+void appendBson(const Value& value, std::vector<uint8_t>& buffer) {
+    BsonWriter writer{buffer};
+    if (auto objectValue = value.cast<ObjectValue>(); objectValue != nullptr) {
+        writer.writeDocument(objectValue->object);
+    } else {
+        Object object{};
+        object.setValue("value", value);
+        writer.writeDocument(object);
+    }
+}
+
+std::vector<uint8_t> toBson(const Object& object) {
+    std::vector<uint8_t> bytes{};
+    BsonWriter writer{bytes};
+    writer.writeDocument(object);
+    return bytes;
+}
+}  // namespace mqlpath
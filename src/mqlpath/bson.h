@@ -0,0 +1,135 @@
+#pragma once
+
+#include "mqlpath/field_name.h"
+#include "mqlpath/field_set.h"
+#include "mqlpath/value.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace mqlpath {
+/**
+ * Read-only view of a BSON value inside a buffer owned by the caller, which must outlive the view.
+ * Navigating a view only reads the bytes it passes over; a Value is built by toValue() alone.
+ *
+ * Doubles, strings, documents, arrays, booleans and int32 map to the corresponding Values, while
+ * undefined, null and a missing field are Nothing. Other BSON types are skipped over when looking
+ * for a field or an element, but materializing one throws std::invalid_argument. So do length
+ * fields which run past the end of the enclosing document.
+ */
+class BsonView {
+public:
+    enum class Type : uint8_t {
+        // Type of the view of a missing field or element.
+        Missing = 0x00,
+        Double = 0x01,
+        String = 0x02,
+        Document = 0x03,
+        Array = 0x04,
+        Undefined = 0x06,
+        Bool = 0x08,
+        Null = 0x0A,
+        Int32 = 0x10,
+    };
+
+    BsonView() = default;
+
+    /**
+     * View of the top-level document stored in 'bytes'.
+     */
+    static BsonView document(std::span<const uint8_t> bytes);
+
+    Type getType() const {
+        return static_cast<Type>(_type);
+    }
+
+    bool isNothing() const {
+        return _type == static_cast<uint8_t>(Type::Missing) ||
+            _type == static_cast<uint8_t>(Type::Undefined) ||
+            _type == static_cast<uint8_t>(Type::Null);
+    }
+
+    bool isDocument() const {
+        return _type == static_cast<uint8_t>(Type::Document);
+    }
+
+    bool isArray() const {
+        return _type == static_cast<uint8_t>(Type::Array);
+    }
+
+    /**
+     * Value of the first field named 'fieldName' of a document, Missing for other views.
+     */
+    BsonView getField(const FieldName& fieldName) const;
+
+    /**
+     * Element at 'index' of an array, Missing for other views.
+     */
+    BsonView getElement(size_t index) const;
+
+    /**
+     * Calls 'callback(name, value)' for every field of a document or element of an array.
+     */
+    template <typename Callback>
+    void forEach(Callback&& callback) const;
+
+    Value toValue() const;
+
+    /**
+     * Builds only the parts of the value in 'projection', see FieldSet::project(). The fields and
+     * elements it leaves out are skipped by their sizes. An empty projection yields the value's
+     * shape().
+     */
+    Value toValue(const FieldSet& projection) const;
+
+private:
+    class ValueConverter;
+
+    BsonView(uint8_t type, const uint8_t* data) : _type(type), _data(data) {}
+
+    /**
+     * Reads the element starting at 'element' of the document or array ending before 'end'.
+     * Returns the position of the next element.
+     */
+    static const uint8_t* readElement(const uint8_t* element,
+                                      const uint8_t* end,
+                                      std::string_view& name,
+                                      BsonView& value);
+
+    uint8_t _type{0};
+    const uint8_t* _data{nullptr};
+};
+
+template <typename Callback>
+void BsonView::forEach(Callback&& callback) const {
+    if (!isDocument() && !isArray()) {
+        return;
+    }
+
+    int32_t size;
+    std::memcpy(&size, _data, sizeof(size));
+    const uint8_t* end = _data + size - 1;
+    for (const uint8_t* element = _data + sizeof(size); element < end;) {
+        std::string_view name;
+        BsonView value;
+        element = readElement(element, end, name, value);
+        callback(name, value);
+    }
+}
+
+/**
+ * Appends the value to 'buffer' as one BSON document. An object is written as it is, any other
+ * value as the field "value" of a document, which stays empty for Nothing. Nothing elements of
+ * arrays are written as undefined. The buffer's existing bytes are kept, so a caller may reuse
+ * one buffer for a stream of documents.
+ */
+void appendBson(const Value& value, std::vector<uint8_t>& buffer);
+
+/**
+ * Encodes the object as a BSON document.
+ */
+std::vector<uint8_t> toBson(const Object& object);
+}  // namespace mqlpath
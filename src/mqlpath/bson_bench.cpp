@@ -0,0 +1,80 @@
+#include "mqlpath/ast_eval.h"
+#include "mqlpath/ast_make.h"
+#include "mqlpath/bson_eval.h"
+#include "mqlpath/path_dependencies.h"
+#include "mqlpath/value.h"
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+namespace mqlpath {
+TEST_CASE("Converted vs in-place BSON evaluation", "[bson][benchmark]") {
+    for (size_t width : {10, 100, 1000}) {
+        Object object{};
+        for (size_t i = 0; i < width; ++i) {
+            object.setValue("field" + std::to_string(i), ast::value("value " + std::to_string(i)));
+        }
+        Array items{};
+        for (int32_t i = 0; i < 10; ++i) {
+            items.emplace_back(ast::value(Object{{{"id", ast::value(i)}}}));
+        }
+        object.setValue("items", Value::make<ArrayValue>(std::move(items)));
+        auto bytes = toBson(object);
+        auto suffix = std::to_string(width) + " fields";
+
+        std::vector<std::pair<std::string, Path>> paths{};
+        paths.emplace_back("Get", ast::get("field1", ast::id()));
+        paths.emplace_back("Traverse Get",
+                           ast::get("items", ast::traverse(ast::get("id", ast::id()))));
+
+        for (const auto& [name, path] : paths) {
+            BENCHMARK("toValue then " + name + " " + suffix) {
+                return evaluate(path, BsonView::document(bytes).toValue());
+            };
+
+            BENCHMARK("projected toValue then " + name + " " + suffix) {
+                return evaluate(path, BsonView::document(bytes).toValue(getReadSet(path)));
+            };
+
+            BENCHMARK("BSON view " + name + " " + suffix) {
+                return evaluate(path, BsonView::document(bytes));
+            };
+        }
+    }
+}
+
+TEST_CASE("BSON writer throughput", "[bson][benchmark]") {
+    for (size_t width : {10, 100, 1000}) {
+        Object object{};
+        for (size_t i = 0; i < width; ++i) {
+            auto name = "field" + std::to_string(i);
+            switch (i % 3) {
+                case 0:
+                    object.setValue(name, ast::value(static_cast<int32_t>(i)));
+                    break;
+                case 1:
+                    object.setValue(name, ast::value(i * 0.5));
+                    break;
+                default:
+                    object.setValue(name, ast::value("some string value " + std::to_string(i)));
+                    break;
+            }
+        }
+        auto document = ast::value(object);
+
+        // 1000 documents per run: divide the bytes by the time for the throughput.
+        std::vector<uint8_t> buffer{};
+        for (int i = 0; i < 1000; ++i) {
+            appendBson(document, buffer);
+        }
+        BENCHMARK("appendBson " + std::to_string(width) + " fields, " +
+                  std::to_string(buffer.size()) + " bytes") {
+            buffer.clear();
+            for (int i = 0; i < 1000; ++i) {
+                appendBson(document, buffer);
+            }
+            return buffer.size();
+        };
+    }
+}
+}  // namespace mqlpath
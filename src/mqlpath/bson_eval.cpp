@@ -0,0 +1,131 @@
+#include "mqlpath/bson_eval.h"
+#include "mqlpath/ast_eval.h"
+#include "mqlpath/path_optimizer.h"
+#include <utility>
+#include <variant>
+
+namespace mqlpath {
+namespace {
+/**
+ * Input of a step: a view into the BSON buffer until a step produces a Value.
+ */
+using Input = std::variant<BsonView, Value>;
+
+Value materialize(Input input) {
+    if (auto view = std::get_if<BsonView>(&input); view != nullptr) {
+        return view->toValue();
+    }
+    return std::move(std::get<Value>(input));
+}
+
+struct BsonPathEval {
+    Input operator()(const Path&, const IdPath&, Input input) {
+        return input;
+    }
+
+    Input operator()(const Path&, const ConstPath& path, Input) {
+        return evaluate(path.expr);
+    }
+
+    Input operator()(const Path&, const DefaultPath& path, Input input) {
+        if (auto view = std::get_if<BsonView>(&input); view != nullptr && view->isNothing()) {
+            return evaluate(path.expr);
+        }
+        if (auto value = std::get_if<Value>(&input); value != nullptr && isNothing(*value)) {
+            return evaluate(path.expr);
+        }
+        return input;
+    }
+
+    Input operator()(const Path&, const ObjPath&, Input input) {
+        if (auto view = std::get_if<BsonView>(&input); view != nullptr) {
+            return view->isDocument() ? input : BsonView{};
+        }
+        return isObject(std::get<Value>(input)) ? std::move(input) : BsonView{};
+    }
+
+    Input operator()(const Path&, const ArrPath&, Input input) {
+        if (auto view = std::get_if<BsonView>(&input); view != nullptr) {
+            return view->isArray() ? input : BsonView{};
+        }
+        return isArray(std::get<Value>(input)) ? std::move(input) : BsonView{};
+    }
+
+    Input operator()(const Path&, const GetPath& path, Input input) {
+        if (auto view = std::get_if<BsonView>(&input); view != nullptr) {
+            return path.path.visit(*this, view->getField(path.fieldName));
+        }
+        const auto& value = std::get<Value>(input);
+        if (isObject(value)) {
+            return path.path.visit(
+                *this, value.cast<ObjectValue>()->object.getValue(path.fieldName));
+        }
+        return path.path.visit(*this, BsonView{});
+    }
+
+    Input operator()(const Path&, const AtPath& path, Input input) {
+        if (auto view = std::get_if<BsonView>(&input); view != nullptr) {
+            return path.path.visit(*this, view->getElement(path.index));
+        }
+        const auto& value = std::get<Value>(input);
+        if (isArray(value)) {
+            const auto& array = value.cast<ArrayValue>()->array;
+            if (array.size() > static_cast<size_t>(path.index)) {
+                return path.path.visit(*this, array[path.index]);
+            }
+        }
+        return path.path.visit(*this, BsonView{});
+    }
+
+    Input operator()(const Path& p, const TraversePath& path, Input input) {
+        auto view = std::get_if<BsonView>(&input);
+        if (view == nullptr) {
+            const auto& value = std::get<Value>(input);
+            if (isArray(value)) {
+                // A materialized array is traversed by the Value evaluator.
+                return evaluate(p, value);
+            }
+            return path.path.visit(*this, std::move(input));
+        }
+        if (!view->isArray()) {
+            return path.path.visit(*this, std::move(input));
+        }
+
+        Array values{};
+        view->forEach([&](std::string_view, BsonView element) {
+            auto outValue =
+                materialize(element.isArray() ? p.visit(*this, Input{element})
+                                              : path.path.visit(*this, Input{element}));
+            if (!isNothing(outValue)) {
+                values.emplace_back(std::move(outValue));
+            }
+        });
+        return Value::make<ArrayValue>(std::move(values));
+    }
+
+    Input operator()(const Path&, const CompositionPath& path, Input input) {
+        return path.right.visit(*this, path.left.visit(*this, std::move(input)));
+    }
+
+    /**
+     * Field, Drop, Keep and Lambda build a new value from their input.
+     */
+    template <typename T>
+    Input operator()(const Path& p, const T&, Input input) {
+        return evaluate(p, materialize(std::move(input)));
+    }
+};
+}  // namespace
+
+Value evaluate(const Path& path, BsonView input) {
+    size_t foldedCount = 0;
+    return detail::evaluateFolded(foldConstants(path, foldedCount), input);
+}
+
+namespace detail {
+Value evaluateFolded(const Path& path, BsonView input) {
+    BsonPathEval eval{};
+    return materialize(path.visit(eval, Input{input}));
+}
+}  // namespace detail
+}  // namespace mqlpath
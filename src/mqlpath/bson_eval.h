@@ -0,0 +1,22 @@
+#pragma once
+
+#include "mqlpath/ast.h"
+#include "mqlpath/bson.h"
+#include "mqlpath/value.h"
+
+namespace mqlpath {
+/**
+ * Evaluates the path over a BSON document without converting the document into a Value. Id, Get,
+ * At, Traverse, Obj, Arr and Default walk the raw bytes; only the result is materialized, plus
+ * the input of a Field, Drop, Keep or Lambda step, which are then evaluated as usual.
+ */
+Value evaluate(const Path& path, BsonView input);
+
+namespace detail {
+/**
+ * evaluate() for a path whose constants are already folded, such as the path of a PreparedPath,
+ * which is evaluated for every document.
+ */
+Value evaluateFolded(const Path& path, BsonView input);
+}  // namespace detail
+}  // namespace mqlpath
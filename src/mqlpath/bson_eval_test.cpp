@@ -0,0 +1,122 @@
+#include "mqlpath/ast_eval.h"
+#include "mqlpath/ast_make.h"
+#include "mqlpath/bson_eval.h"
+#include "mqlpath/path_dependencies.h"
+#include "mqlpath/random_generator.h"
+#include <catch2/catch_message.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <stdexcept>
+
+namespace mqlpath {
+namespace {
+Object makeDocument(RandomGenerator& generator) {
+    auto value = generator.value(3);
+    if (isObject(value)) {
+        return value.cast<ObjectValue>()->object;
+    }
+    Object object{};
+    object.setValue("a", std::move(value));
+    return object;
+}
+}  // namespace
+
+TEST_CASE("BSON documents convert back to the same Value", "[bson]") {
+    RandomGenerator generator{20231016};
+    for (int i = 0; i < 1000; ++i) {
+        auto document = makeDocument(generator);
+        INFO(document);
+        auto bytes = toBson(document);
+        REQUIRE(ast::value(document) == BsonView::document(bytes).toValue());
+    }
+}
+
+TEST_CASE("appendBson writes consecutive documents", "[bson]") {
+    std::vector<uint8_t> buffer{};
+    auto object = Object{{{"a", ast::value(std::vector<int32_t>{1, 2})}, {"b", ast::value("x")}}};
+    appendBson(ast::value(object), buffer);
+    const size_t firstSize = buffer.size();
+    REQUIRE(std::vector<uint8_t>(buffer.begin(), buffer.end()) == toBson(object));
+
+    appendBson(ast::value(2.5), buffer);
+    appendBson(ast::nothing(), buffer);
+    const std::span<const uint8_t> bytes{buffer};
+
+    REQUIRE(ast::value(object) == BsonView::document(bytes.first(firstSize)).toValue());
+    auto second = bytes.subspan(firstSize, buffer.size() - firstSize - 5);
+    REQUIRE(ast::value(Object{{{"value", ast::value(2.5)}}}) ==
+            BsonView::document(second).toValue());
+    REQUIRE(ast::value(Object{}) == BsonView::document(bytes.last(5)).toValue());
+}
+
+TEST_CASE("BSON view navigates fields and elements", "[bson]") {
+    auto bytes = toBson(Object{{
+        {"a", ast::value(std::vector<int32_t>{10, 20, 30})},
+        {"b", ast::value(Object{{{"c", ast::value("text")}, {"d", ast::value(1.5)}}})},
+        {"e", ast::value(true)},
+    }});
+    auto document = BsonView::document(bytes);
+
+    REQUIRE(document.isDocument());
+    REQUIRE(document.getField("a").isArray());
+    REQUIRE(ast::value(30) == document.getField("a").getElement(2).toValue());
+    REQUIRE(document.getField("a").getElement(3).isNothing());
+    REQUIRE(ast::value("text") == document.getField("b").getField("c").toValue());
+    REQUIRE(ast::value(1.5) == document.getField("b").getField("d").toValue());
+    REQUIRE(ast::value(true) == document.getField("e").toValue());
+    REQUIRE(document.getField("missing").isNothing());
+    REQUIRE(document.getField("e").getField("a").isNothing());
+    REQUIRE(document.getElement(0).isNothing());
+}
+
+TEST_CASE("BSON view skips unsupported types and rejects malformed input", "[bson]") {
+    // {"x": int64 7, "y": int32 5}
+    std::vector<uint8_t> bytes{0x1A, 0, 0, 0, 0x12, 'x', 0, 7, 0, 0, 0, 0, 0, 0, 0,
+                               0x10, 'y', 0, 5, 0, 0, 0, 0};
+    bytes[0] = static_cast<uint8_t>(bytes.size());
+    auto document = BsonView::document(bytes);
+    REQUIRE(ast::value(5) == document.getField("y").toValue());
+    REQUIRE_THROWS_AS(document.getField("x").toValue(), std::invalid_argument);
+    REQUIRE_THROWS_AS(document.toValue(), std::invalid_argument);
+    // Left out by the projection, the int64 is never read.
+    REQUIRE(ast::value(Object{{{"y", ast::value(5)}}}) ==
+            document.toValue(getReadSet(ast::get("y", ast::id()))));
+
+    // The declared size of the string runs past the end of the document.
+    std::vector<uint8_t> truncated{0x0F, 0, 0, 0, 0x02, 's', 0, 0x40, 0, 0, 0, 'a', 'b', 0, 0};
+    REQUIRE_THROWS_AS(BsonView::document(truncated).getField("t"), std::invalid_argument);
+    REQUIRE_THROWS_AS(BsonView::document(std::span{truncated}.first(10)), std::invalid_argument);
+}
+
+TEST_CASE("paths over BSON evaluate as over Values", "[bson]") {
+    RandomGenerator generator{20231017};
+    for (int i = 0; i < 2000; ++i) {
+        auto path = generator.path(4);
+        INFO(path);
+
+        for (int j = 0; j < 5; ++j) {
+            auto document = makeDocument(generator);
+            INFO(document);
+            auto bytes = toBson(document);
+            REQUIRE(evaluate(ast::evalPath(path, ast::value(document))) ==
+                    evaluate(path, BsonView::document(bytes)));
+        }
+    }
+}
+
+TEST_CASE("BSON documents convert to the projections of read sets", "[bson]") {
+    RandomGenerator generator{20241018};
+    for (int i = 0; i < 2000; ++i) {
+        auto projection = getReadSet(generator.path(4));
+        INFO(projection);
+        for (int j = 0; j < 5; ++j) {
+            auto document = ast::value(makeDocument(generator));
+            INFO(document);
+            auto bytes = toBson(document.cast<ObjectValue>()->object);
+            // The readers build the shape of a document which is not read at all.
+            const auto& built = projection.isEmpty() ? FieldSet::shape() : projection;
+            auto expected = built.project(document);
+            REQUIRE(expected == BsonView::document(bytes).toValue(projection));
+        }
+    }
+}
+}  // namespace mqlpath
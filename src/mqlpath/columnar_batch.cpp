@@ -0,0 +1,55 @@
+#include "mqlpath/columnar_batch.h"
+#include <algorithm>
+
+namespace mqlpath {
+void ColumnarBatch::append(const Value& value) {
+    const size_t row = _size;
+    if (row == _bools.values.size()) {
+        grow(std::max<size_t>(64, row * 2));
+    }
+    ++_size;
+
+    if (auto scalarValue = value.cast<ScalarValue>(); scalarValue != nullptr) {
+        const auto& scalar = scalarValue->scalar;
+        if (auto boolValue = std::get_if<bool>(&scalar); boolValue != nullptr) {
+            _bools.values[row] = *boolValue;
+            _bools.validity.set(row);
+        } else if (auto int32Value = std::get_if<int32_t>(&scalar); int32Value != nullptr) {
+            _int32s.values[row] = *int32Value;
+            _int32s.validity.set(row);
+        } else if (auto doubleValue = std::get_if<double>(&scalar); doubleValue != nullptr) {
+            _doubles.values[row] = *doubleValue;
+            _doubles.validity.set(row);
+        } else {
+            _strings.bytes.append(std::get<std::string>(scalar));
+            _strings.validity.set(row);
+        }
+    } else if (isArray(value) || isObject(value)) {
+        _others.emplace_back(row, value);
+    }
+    _strings.offsets.push_back(_strings.bytes.size());
+}
+
+void ColumnarBatch::reserve(size_t rows) {
+    if (rows > _bools.values.size()) {
+        grow(rows);
+    }
+    _strings.offsets.reserve(rows + 1);
+}
+
+void ColumnarBatch::clear() {
+    // Keeps the capacity of the columns for the next batch.
+    _size = 0;
+    grow(0);
+    _strings.offsets.resize(1);
+    _strings.bytes.clear();
+    _others.clear();
+}
+
+void ColumnarBatch::grow(size_t rows) {
+    _bools.resize(rows);
+    _int32s.resize(rows);
+    _doubles.resize(rows);
+    _strings.validity.resize(rows);
+}
+}  // namespace mqlpath
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "mqlpath/value.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace mqlpath {
+/**
+ * One bit per row telling whether the row holds a value.
+ */
+class ValidityBitmap {
+public:
+    bool test(size_t row) const {
+        return (_words[row / 64] >> (row % 64)) & 1;
+    }
+
+    void set(size_t row) {
+        _words[row / 64] |= uint64_t{1} << (row % 64);
+    }
+
+    /**
+     * Grows or shrinks the bitmap to 'rows' bits. Added rows are invalid.
+     */
+    void resize(size_t rows) {
+        if (rows < _size) {
+            _words.resize((rows + 63) / 64);
+            if (rows % 64 != 0) {
+                _words.back() &= (uint64_t{1} << (rows % 64)) - 1;
+            }
+        } else {
+            _words.resize((rows + 63) / 64, 0);
+        }
+        _size = rows;
+    }
+
+    size_t size() const {
+        return _size;
+    }
+
+    const std::vector<uint64_t>& getWords() const {
+        return _words;
+    }
+
+private:
+    std::vector<uint64_t> _words;
+    size_t _size{0};
+};
+
+/**
+ * Column of fixed-width values. Rows which do not hold a value of this column's type are zero
+ * and marked invalid. 'values' may be longer than the batch, only its first size() rows are used.
+ */
+template <typename T>
+struct FixedColumn {
+    std::vector<T> values;
+    ValidityBitmap validity;
+
+    void resize(size_t rows) {
+        values.resize(rows);
+        validity.resize(rows);
+    }
+};
+
+/**
+ * Column of strings stored back to back in 'bytes'. The string of row i spans
+ * [offsets[i], offsets[i + 1]), which is empty for rows without a string. Offsets are 64-bit as
+ * the strings of a batch may add up to more than 4 GiB.
+ */
+struct StringColumn {
+    std::vector<uint64_t> offsets{0};
+    std::string bytes;
+    ValidityBitmap validity;
+
+    std::string_view getValue(size_t row) const {
+        return std::string_view{bytes}.substr(offsets[row], offsets[row + 1] - offsets[row]);
+    }
+};
+
+/**
+ * Results of a batch stored by type instead of as one Value per document, for paths which
+ * extract scalars. Every column has one row per document and a row is valid in at most one
+ * column: a Nothing result is invalid in all of them. Arrays and objects have no column and are
+ * kept as Values together with their row.
+ */
+class ColumnarBatch {
+public:
+    void append(const Value& value);
+
+    void reserve(size_t rows);
+
+    void clear();
+
+    size_t size() const {
+        return _size;
+    }
+
+    const FixedColumn<uint8_t>& getBools() const {
+        return _bools;
+    }
+
+    const FixedColumn<int32_t>& getInt32s() const {
+        return _int32s;
+    }
+
+    const FixedColumn<double>& getDoubles() const {
+        return _doubles;
+    }
+
+    const StringColumn& getStrings() const {
+        return _strings;
+    }
+
+    const std::vector<std::pair<size_t, Value>>& getOthers() const {
+        return _others;
+    }
+
+private:
+    /**
+     * Makes room for 'rows' rows in every column. The new rows are zero and invalid.
+     */
+    void grow(size_t rows);
+
+    size_t _size{0};
+    FixedColumn<uint8_t> _bools;
+    FixedColumn<int32_t> _int32s;
+    FixedColumn<double> _doubles;
+    StringColumn _strings;
+    std::vector<std::pair<size_t, Value>> _others;
+};
+}  // namespace mqlpath
@@ -0,0 +1,73 @@
+#include "mqlpath/ast_make.h"
+#include "mqlpath/columnar_batch.h"
+#include <catch2/catch_test_macros.hpp>
+
+namespace mqlpath {
+TEST_CASE("columnar batch stores scalars by type", "[columnar]") {
+    ColumnarBatch batch{};
+    batch.append(ast::value(7));
+    batch.append(ast::nothing());
+    batch.append(ast::value("abc"));
+    batch.append(ast::value(2.5));
+    batch.append(ast::value(true));
+    batch.append(ast::value(std::vector<int32_t>{1, 2}));
+    batch.append(ast::value(""));
+
+    REQUIRE(batch.size() == 7);
+
+    const auto& int32s = batch.getInt32s();
+    REQUIRE(int32s.validity.test(0));
+    REQUIRE(int32s.values[0] == 7);
+    for (size_t row = 1; row < 7; ++row) {
+        REQUIRE(!int32s.validity.test(row));
+        REQUIRE(int32s.values[row] == 0);
+    }
+
+    REQUIRE(batch.getDoubles().validity.test(3));
+    REQUIRE(batch.getDoubles().values[3] == 2.5);
+    REQUIRE(batch.getBools().validity.test(4));
+    REQUIRE(batch.getBools().values[4] == 1);
+
+    const auto& strings = batch.getStrings();
+    REQUIRE(strings.validity.test(2));
+    REQUIRE(strings.getValue(2) == "abc");
+    REQUIRE(strings.validity.test(6));
+    REQUIRE(strings.getValue(6).empty());
+    REQUIRE(!strings.validity.test(0));
+    REQUIRE(strings.getValue(0).empty());
+
+    // Nothing is invalid in every column.
+    REQUIRE(!batch.getBools().validity.test(1));
+    REQUIRE(!batch.getDoubles().validity.test(1));
+    REQUIRE(!strings.validity.test(1));
+
+    REQUIRE(batch.getOthers().size() == 1);
+    REQUIRE(batch.getOthers()[0].first == 5);
+    REQUIRE(batch.getOthers()[0].second == ast::value(std::vector<int32_t>{1, 2}));
+
+    batch.clear();
+    REQUIRE(batch.size() == 0);
+    REQUIRE(batch.getStrings().offsets.size() == 1);
+    REQUIRE(batch.getOthers().empty());
+}
+
+TEST_CASE("validity bitmap spans multiple words", "[columnar]") {
+    ValidityBitmap bitmap{};
+    bitmap.resize(200);
+    for (size_t row = 0; row < 200; row += 3) {
+        bitmap.set(row);
+    }
+    REQUIRE(bitmap.size() == 200);
+    REQUIRE(bitmap.getWords().size() == 4);
+    for (size_t row = 0; row < 200; ++row) {
+        REQUIRE(bitmap.test(row) == (row % 3 == 0));
+    }
+
+    // Rows cut off by shrinking are invalid when the bitmap grows again.
+    bitmap.resize(70);
+    bitmap.resize(200);
+    for (size_t row = 0; row < 200; ++row) {
+        REQUIRE(bitmap.test(row) == (row < 70 && row % 3 == 0));
+    }
+}
+}  // namespace mqlpath
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "mqlpath/ast_make.h"
+#include "mqlpath/value.h"
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace mqlpath {
+struct CorpusOptions {
+    // Fields of every object.
+    size_t width{10};
+    // Levels of objects and arrays below the top-level document.
+    size_t depth{2};
+    // Elements of every array.
+    size_t arrayLength{4};
+
+    // Relative weights of the scalar types.
+    uint32_t int32Weight{4};
+    uint32_t doubleWeight{2};
+    uint32_t stringWeight{3};
+    uint32_t boolWeight{1};
+
+    // Relative weight of nested objects and arrays against scalars, while below 'depth'.
+    uint32_t objectWeight{1};
+    uint32_t arrayWeight{1};
+
+    uint32_t seed{42};
+};
+
+/**
+ * Generates documents of the same shape for benchmarks. The shape is drawn once from the seed:
+ * the fields of every object are named "f0", "f1", ... and each has a fixed kind, so one path
+ * reaches the same kind of value in every document while the scalars differ. In every object
+ * above 'depth', "f0" is an object and "f1" an array, which gives benchmarks a known place to
+ * look for both.
+ *
+ * Only std::mt19937 is used for randomness, never the standard distributions, so a seed yields the
+ * same corpus with every standard library.
+ */
+class CorpusGenerator {
+public:
+    explicit CorpusGenerator(const CorpusOptions& options)
+        : _options(options), _random(options.seed) {
+        _shape = makeShape(0);
+    }
+
+    Value document() {
+        return fill(_shape);
+    }
+
+    std::vector<Value> documents(size_t count) {
+        std::vector<Value> result{};
+        result.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            result.emplace_back(document());
+        }
+        return result;
+    }
+
+    static std::string fieldName(size_t index) {
+        return "f" + std::to_string(index);
+    }
+
+private:
+    enum class Kind { Int32, Double, String, Bool, Object, Array };
+
+    struct Shape {
+        Kind kind;
+        std::vector<Shape> children;
+    };
+
+    Shape makeShape(size_t level) {
+        Shape shape{Kind::Object, {}};
+        for (size_t index = 0; index < _options.width; ++index) {
+            shape.children.emplace_back(makeFieldShape(level, index));
+        }
+        return shape;
+    }
+
+    Shape makeFieldShape(size_t level, size_t index) {
+        if (level < _options.depth) {
+            if (index == 0) {
+                return makeShape(level + 1);
+            }
+            if (index == 1 && _options.arrayLength > 0) {
+                return makeArrayShape(level);
+            }
+            const uint32_t scalarWeight = _options.int32Weight + _options.doubleWeight +
+                _options.stringWeight + _options.boolWeight;
+            const uint32_t pick =
+                next(scalarWeight + _options.objectWeight + _options.arrayWeight);
+            if (pick >= scalarWeight + _options.objectWeight) {
+                return makeArrayShape(level);
+            }
+            if (pick >= scalarWeight) {
+                return makeShape(level + 1);
+            }
+        }
+        return Shape{pickScalarKind(), {}};
+    }
+
+    /**
+     * Arrays hold elements of one kind: scalars, or objects while below 'depth'.
+     */
+    Shape makeArrayShape(size_t level) {
+        Shape element = level + 1 < _options.depth && next(2) == 0 ? makeShape(level + 1)
+                                                                   : Shape{pickScalarKind(), {}};
+        return Shape{Kind::Array, {std::move(element)}};
+    }
+
+    Kind pickScalarKind() {
+        uint32_t pick = next(_options.int32Weight + _options.doubleWeight +
+                             _options.stringWeight + _options.boolWeight);
+        if (pick < _options.int32Weight) {
+            return Kind::Int32;
+        }
+        pick -= _options.int32Weight;
+        if (pick < _options.doubleWeight) {
+            return Kind::Double;
+        }
+        pick -= _options.doubleWeight;
+        return pick < _options.stringWeight ? Kind::String : Kind::Bool;
+    }
+
+    Value fill(const Shape& shape) {
+        switch (shape.kind) {
+            case Kind::Int32:
+                return ast::value(static_cast<int32_t>(next(100000)));
+            case Kind::Double:
+                return ast::value(next(100000) / 8.0);
+            case Kind::String: {
+                std::string text(4 + next(13), ' ');
+                for (auto& c : text) {
+                    c = static_cast<char>('a' + next(26));
+                }
+                return ast::value(std::move(text));
+            }
+            case Kind::Bool:
+                return ast::value(next(2) == 1);
+            case Kind::Object: {
+                Object::Fields fields{};
+                fields.reserve(shape.children.size());
+                for (size_t index = 0; index < shape.children.size(); ++index) {
+                    fields.emplace_back(fieldName(index), fill(shape.children[index]));
+                }
+                return ast::value(Object{std::move(fields)});
+            }
+            case Kind::Array: {
+                Array elements{};
+                elements.reserve(_options.arrayLength);
+                for (size_t index = 0; index < _options.arrayLength; ++index) {
+                    elements.emplace_back(fill(shape.children[0]));
+                }
+                return Value::make<ArrayValue>(std::move(elements));
+            }
+        }
+        return ast::nothing();
+    }
+
+    /**
+     * Random number in [0, bound), 0 for an empty range.
+     */
+    uint32_t next(uint32_t bound) {
+        return bound == 0 ? 0 : static_cast<uint32_t>(_random() % bound);
+    }
+
+    CorpusOptions _options;
+    std::mt19937 _random;
+    Shape _shape;
+};
+}  // namespace mqlpath
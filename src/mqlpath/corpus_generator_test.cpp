@@ -0,0 +1,71 @@
+#include "mqlpath/corpus_generator.h"
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <variant>
+
+namespace mqlpath {
+namespace {
+/**
+ * Depth of nested objects and arrays below the value.
+ */
+size_t nesting(const Value& value) {
+    size_t deepest = 0;
+    if (auto objectValue = value.cast<ObjectValue>(); objectValue != nullptr) {
+        for (const auto& field : objectValue->object.getValues()) {
+            deepest = std::max(deepest, 1 + nesting(field));
+        }
+    } else if (auto arrayValue = value.cast<ArrayValue>(); arrayValue != nullptr) {
+        for (const auto& element : arrayValue->array) {
+            deepest = std::max(deepest, 1 + nesting(element));
+        }
+    }
+    return deepest;
+}
+}  // namespace
+
+TEST_CASE("corpus generator is deterministic", "[corpus_generator]") {
+    CorpusOptions options{};
+    CorpusGenerator first{options};
+    CorpusGenerator second{options};
+    REQUIRE(first.documents(10) == second.documents(10));
+
+    options.seed = 7;
+    CorpusGenerator other{options};
+    REQUIRE(first.documents(10) != other.documents(10));
+}
+
+TEST_CASE("corpus generator follows its options", "[corpus_generator]") {
+    CorpusOptions options{};
+    options.width = 5;
+    options.depth = 3;
+    options.arrayLength = 2;
+    CorpusGenerator generator{options};
+
+    for (const auto& document : generator.documents(5)) {
+        const auto& object = document.cast<ObjectValue>()->object;
+        REQUIRE(object.size() == 5);
+        REQUIRE(isObject(object.getValue("f0")));
+        REQUIRE(isArray(object.getValue("f1")));
+        REQUIRE(object.getValue("f1").cast<ArrayValue>()->array.size() == 2);
+        // Scalars sit one level below the deepest object.
+        REQUIRE(nesting(document) == 4);
+    }
+}
+
+TEST_CASE("corpus generator draws only the weighted scalar types", "[corpus_generator]") {
+    CorpusOptions options{};
+    options.depth = 0;
+    options.int32Weight = 0;
+    options.doubleWeight = 0;
+    options.boolWeight = 0;
+    CorpusGenerator generator{options};
+
+    auto document = generator.document();
+    for (const auto& value : document.cast<ObjectValue>()->object.getValues()) {
+        auto scalarValue = value.cast<ScalarValue>();
+        REQUIRE(scalarValue != nullptr);
+        REQUIRE(std::holds_alternative<std::string>(scalarValue->scalar));
+    }
+}
+}  // namespace mqlpath
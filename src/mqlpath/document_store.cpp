@@ -0,0 +1,173 @@
+#include "mqlpath/document_store.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace mqlpath {
+namespace {
+uint64_t readUint64(const uint8_t* data) {
+    uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+void appendUint64(std::vector<uint8_t>& bytes, uint64_t value) {
+    const auto data = reinterpret_cast<const uint8_t*>(&value);
+    bytes.insert(bytes.end(), data, data + sizeof(value));
+}
+
+[[noreturn]] void throwCorrupt(const std::string& fileName, const char* reason) {
+    throw std::invalid_argument(fileName + " is not a document store: " + reason);
+}
+
+[[noreturn]] void throwCorruptIndex() {
+    throw std::invalid_argument("corrupt document store index");
+}
+}  // namespace
+
+DocumentStoreWriter::DocumentStoreWriter(std::ostream& output) : _output(output) {
+    _output.write(DocumentStoreFormat::kHeaderMagic, sizeof(DocumentStoreFormat::kHeaderMagic));
+    const uint32_t words[2] = {DocumentStoreFormat::kVersion, 0};
+    _output.write(reinterpret_cast<const char*>(words), sizeof(words));
+}
+
+void DocumentStoreWriter::append(const Value& document) {
+    _buffer.clear();
+    mqlpath::appendBson(document, _buffer);
+    appendBson(_buffer);
+}
+
+void DocumentStoreWriter::appendBson(std::span<const uint8_t> documents) {
+    // Nothing is appended unless all documents are complete.
+    const size_t previousSize = _offsets.size();
+    for (size_t position = 0; position < documents.size();) {
+        int32_t size = 0;
+        if (documents.size() - position >= sizeof(size)) {
+            std::memcpy(&size, documents.data() + position, sizeof(size));
+        }
+        if (size < 5 || static_cast<size_t>(size) > documents.size() - position) {
+            _offsets.resize(previousSize);
+            throw std::invalid_argument("truncated or invalid BSON document");
+        }
+        _offsets.push_back(_offset + position);
+        position += static_cast<size_t>(size);
+    }
+    _output.write(reinterpret_cast<const char*>(documents.data()),
+                  static_cast<std::streamsize>(documents.size()));
+    _offset += documents.size();
+}
+
+void DocumentStoreWriter::finish() {
+    std::vector<uint8_t> tail{};
+    tail.reserve((_offsets.size() + 1) * sizeof(uint64_t) + DocumentStoreFormat::kFooterSize);
+    for (auto offset : _offsets) {
+        appendUint64(tail, offset);
+    }
+    appendUint64(tail, _offset);
+    appendUint64(tail, _offsets.size());
+    appendUint64(tail, _offset);
+    tail.insert(tail.end(),
+                std::begin(DocumentStoreFormat::kFooterMagic),
+                std::end(DocumentStoreFormat::kFooterMagic));
+    _output.write(reinterpret_cast<const char*>(tail.data()),
+                  static_cast<std::streamsize>(tail.size()));
+    _output.flush();
+}
+
+DocumentStore::DocumentStore(const std::string& fileName) {
+    const int fd = ::open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "cannot open " + fileName);
+    }
+    struct stat status {};
+    if (::fstat(fd, &status) != 0) {
+        const int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "cannot stat " + fileName);
+    }
+    _fileSize = static_cast<size_t>(status.st_size);
+    if (_fileSize < DocumentStoreFormat::kHeaderSize + sizeof(uint64_t) +
+            DocumentStoreFormat::kFooterSize) {
+        ::close(fd);
+        throwCorrupt(fileName, "too small");
+    }
+
+    void* mapping = ::mmap(nullptr, _fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    const int error = errno;
+    // The mapping stays valid once the file is closed.
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::system_error(error, std::generic_category(), "cannot map " + fileName);
+    }
+    _data = static_cast<const uint8_t*>(mapping);
+
+    const auto footer = _data + _fileSize - DocumentStoreFormat::kFooterSize;
+    uint32_t version;
+    std::memcpy(&version, _data + sizeof(DocumentStoreFormat::kHeaderMagic), sizeof(version));
+    const char* reason = nullptr;
+    if (std::memcmp(_data, DocumentStoreFormat::kHeaderMagic, 8) != 0 ||
+        std::memcmp(footer + 16, DocumentStoreFormat::kFooterMagic, 8) != 0) {
+        reason = "missing magic bytes";
+    } else if (version != DocumentStoreFormat::kVersion) {
+        reason = "unsupported version";
+    } else {
+        _size = readUint64(footer);
+        _indexOffset = readUint64(footer + 8);
+        const uint64_t indexEnd = _fileSize - DocumentStoreFormat::kFooterSize;
+        // The index holds one offset per document plus the end of the last one.
+        if (_indexOffset < DocumentStoreFormat::kHeaderSize || _indexOffset >= indexEnd ||
+            (indexEnd - _indexOffset) % sizeof(uint64_t) != 0 ||
+            (indexEnd - _indexOffset) / sizeof(uint64_t) - 1 != _size) {
+            reason = "index does not match the file size";
+        }
+    }
+    if (reason != nullptr) {
+        ::munmap(mapping, _fileSize);
+        throwCorrupt(fileName, reason);
+    }
+}
+
+DocumentStore::~DocumentStore() {
+    ::munmap(const_cast<uint8_t*>(_data), _fileSize);
+}
+
+std::span<const uint8_t> DocumentStore::getBytes(size_t index) const {
+    if (index >= _size) {
+        throw std::out_of_range("document " + std::to_string(index) + " of a store of " +
+                                std::to_string(_size));
+    }
+    const uint64_t begin = getOffset(index);
+    const uint64_t end = getOffset(index + 1);
+    if (begin < DocumentStoreFormat::kHeaderSize || begin >= end || end > _indexOffset) {
+        throwCorruptIndex();
+    }
+    return {_data + begin, static_cast<size_t>(end - begin)};
+}
+
+uint64_t DocumentStore::getOffset(size_t index) const {
+    return readUint64(_data + _indexOffset + index * sizeof(uint64_t));
+}
+
+void DocumentStore::adviseSequential(size_t first, size_t last) const {
+    if (first >= last || last > _size) {
+        return;
+    }
+    // madvise() wants a page-aligned start.
+    const uint64_t begin = getOffset(first);
+    const uint64_t end = std::min<uint64_t>(getOffset(last), _indexOffset);
+    if (begin >= end) {
+        return;
+    }
+    const auto pageSize = static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+    const uint64_t alignedBegin = begin / pageSize * pageSize;
+    ::madvise(const_cast<uint8_t*>(_data) + alignedBegin, end - alignedBegin, MADV_SEQUENTIAL);
+}
+}  // namespace mqlpath
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "mqlpath/bson.h"
+#include "mqlpath/value.h"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace mqlpath {
+/**
+ * Layout of a document store file, all integers little-endian:
+ *
+ *   header   "MQLSTORE", uint32 version, uint32 zero
+ *   documents, each one BSON document
+ *   index    uint64 offset of every document, then the offset of the index itself
+ *   footer   uint64 document count, uint64 offset of the index, "MQLSTEND"
+ *
+ * The index follows the documents so that a store can be written in one pass to a stream which
+ * cannot seek, such as a pipe.
+ */
+struct DocumentStoreFormat {
+    static constexpr char kHeaderMagic[8] = {'M', 'Q', 'L', 'S', 'T', 'O', 'R', 'E'};
+    static constexpr char kFooterMagic[8] = {'M', 'Q', 'L', 'S', 'T', 'E', 'N', 'D'};
+    static constexpr uint32_t kVersion = 1;
+    static constexpr size_t kHeaderSize = 16;
+    static constexpr size_t kFooterSize = 24;
+};
+
+/**
+ * Writes a document store to a stream, one document at a time. Only the offsets of the documents
+ * are kept in memory until finish() writes the index.
+ */
+class DocumentStoreWriter {
+public:
+    explicit DocumentStoreWriter(std::ostream& output);
+
+    /**
+     * Appends the value as a BSON document, see appendBson().
+     */
+    void append(const Value& document);
+
+    /**
+     * Appends BSON documents stored back to back in 'documents'. Throws std::invalid_argument if
+     * their sizes do not add up to the size of the span, without appending any of them.
+     */
+    void appendBson(std::span<const uint8_t> documents);
+
+    /**
+     * Writes the index and the footer. No documents may be appended afterwards.
+     */
+    void finish();
+
+    size_t size() const {
+        return _offsets.size();
+    }
+
+private:
+    std::ostream& _output;
+    uint64_t _offset{DocumentStoreFormat::kHeaderSize};
+    std::vector<uint64_t> _offsets;
+    std::vector<uint8_t> _buffer;
+};
+
+/**
+ * Read-only document store mapped into memory. Documents are returned as BsonViews of the mapped
+ * file, so neither opening the store nor reading a document copies it to the heap, and the
+ * operating system pages the file in as it is read. The views are valid as long as the store.
+ *
+ * Opening checks the header, the footer and the size of the index. The offsets of a document are
+ * checked when it is accessed, throwing std::invalid_argument if the file is corrupt.
+ */
+class DocumentStore {
+public:
+    /**
+     * Maps the file. Throws std::system_error if it cannot be opened or mapped and
+     * std::invalid_argument if it is not a document store.
+     */
+    explicit DocumentStore(const std::string& fileName);
+    ~DocumentStore();
+
+    DocumentStore(const DocumentStore&) = delete;
+    DocumentStore& operator=(const DocumentStore&) = delete;
+
+    size_t size() const {
+        return _size;
+    }
+
+    /**
+     * The document at 'index', which must be below size().
+     */
+    BsonView getDocument(size_t index) const {
+        return BsonView::document(getBytes(index));
+    }
+
+    /**
+     * The bytes of the BSON document at 'index'.
+     */
+    std::span<const uint8_t> getBytes(size_t index) const;
+
+    /**
+     * Calls 'callback(document)' for the documents in [first, last) in order, telling the
+     * operating system to read the range ahead.
+     */
+    template <typename Callback>
+    void forEach(size_t first, size_t last, Callback&& callback) const;
+
+    template <typename Callback>
+    void forEach(Callback&& callback) const {
+        forEach(0, _size, callback);
+    }
+
+private:
+    uint64_t getOffset(size_t index) const;
+
+    /**
+     * Hints that the documents in [first, last) are about to be read in order.
+     */
+    void adviseSequential(size_t first, size_t last) const;
+
+    const uint8_t* _data{nullptr};
+    size_t _fileSize{0};
+    size_t _size{0};
+    uint64_t _indexOffset{0};
+};
+
+template <typename Callback>
+void DocumentStore::forEach(size_t first, size_t last, Callback&& callback) const {
+    adviseSequential(first, last);
+    for (size_t index = first; index < last; ++index) {
+        callback(getDocument(index));
+    }
+}
+}  // namespace mqlpath
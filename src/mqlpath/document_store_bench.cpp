@@ -0,0 +1,62 @@
+#include "mqlpath/ast_make.h"
+#include "mqlpath/bson_eval.h"
+#include "mqlpath/document_store.h"
+#include "mqlpath/json.h"
+#include "mqlpath/temporary_file.h"
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+namespace mqlpath {
+TEST_CASE("Reading a corpus from NDJSON vs a document store", "[document_store][benchmark]") {
+    std::string ndjson{};
+    for (int i = 0; i < 10000; ++i) {
+        auto id = std::to_string(i);
+        ndjson += R"({"id": )" + id + R"(, "name": "document number )" + id + R"(", "score": )" +
+            std::to_string(i * 0.25) + R"(, "tags": ["alpha", "beta", "gamma"], )" +
+            R"("address": {"street": "Main Street )" + id + R"(", "zip": 12345}})" + "\n";
+    }
+    std::vector<Value> documents{};
+    parseNdjson(ndjson, documents);
+
+    TemporaryFile file{"bench.store"};
+    {
+        std::ofstream output{file.getName(), std::ios::binary};
+        DocumentStoreWriter writer{output};
+        for (const auto& document : documents) {
+            writer.append(document);
+        }
+        writer.finish();
+    }
+    DocumentStore store{file.getName()};
+    auto path = ast::get("address", ast::get("zip", ast::id()));
+
+    BENCHMARK("parseNdjson 10000 documents") {
+        std::vector<Value> values{};
+        parseNdjson(ndjson, values);
+        return values.size();
+    };
+
+    BENCHMARK("store toValue 10000 documents") {
+        std::vector<Value> values{};
+        values.reserve(store.size());
+        store.forEach([&](BsonView document) { values.emplace_back(document.toValue()); });
+        return values.size();
+    };
+
+    BENCHMARK("store in-place Get 10000 documents") {
+        size_t count = 0;
+        store.forEach([&](BsonView document) { count += !isNothing(evaluate(path, document)); });
+        return count;
+    };
+
+    BENCHMARK("store random access Get 10000 documents") {
+        size_t count = 0;
+        for (size_t i = 0; i < store.size(); ++i) {
+            const size_t index = (i * 7919) % store.size();
+            count += !isNothing(evaluate(path, store.getDocument(index)));
+        }
+        return count;
+    };
+}
+}  // namespace mqlpath
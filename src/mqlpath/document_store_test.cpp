@@ -0,0 +1,123 @@
+#include "mqlpath/ast_make.h"
+#include "mqlpath/bson_eval.h"
+#include "mqlpath/document_store.h"
+#include "mqlpath/temporary_file.h"
+#include <catch2/catch_test_macros.hpp>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+namespace mqlpath {
+namespace {
+Value makeDocument(int32_t i) {
+    return ast::value(Object{{
+        {"id", ast::value(i)},
+        {"name", ast::value("document " + std::to_string(i))},
+        {"tags", ast::value(std::vector<int32_t>{i, i + 1})},
+    }});
+}
+}  // namespace
+
+TEST_CASE("document store reads back the written documents", "[document_store]") {
+    TemporaryFile file{"documents.store"};
+    {
+        std::ofstream output{file.getName(), std::ios::binary};
+        DocumentStoreWriter writer{output};
+        for (int32_t i = 0; i < 1000; ++i) {
+            writer.append(makeDocument(i));
+        }
+        REQUIRE(writer.size() == 1000);
+        writer.finish();
+    }
+
+    DocumentStore store{file.getName()};
+    REQUIRE(store.size() == 1000);
+    REQUIRE(makeDocument(0) == store.getDocument(0).toValue());
+    REQUIRE(makeDocument(617) == store.getDocument(617).toValue());
+    REQUIRE(makeDocument(999) == store.getDocument(999).toValue());
+    REQUIRE_THROWS_AS(store.getDocument(1000), std::out_of_range);
+
+    // Documents are evaluated in place.
+    REQUIRE(ast::value(618) ==
+            evaluate(ast::get("tags", ast::at(1, ast::id())), store.getDocument(617)));
+
+    int32_t expected = 0;
+    store.forEach([&](BsonView document) {
+        REQUIRE(makeDocument(expected++) == document.toValue());
+    });
+    REQUIRE(expected == 1000);
+
+    expected = 10;
+    store.forEach(10, 20, [&](BsonView document) {
+        REQUIRE(makeDocument(expected++) == document.toValue());
+    });
+    REQUIRE(expected == 20);
+}
+
+TEST_CASE("document store writer takes encoded documents", "[document_store]") {
+    TemporaryFile file{"encoded.store"};
+    std::vector<uint8_t> bytes{};
+    appendBson(makeDocument(1), bytes);
+    appendBson(makeDocument(2), bytes);
+    {
+        std::ofstream output{file.getName(), std::ios::binary};
+        DocumentStoreWriter writer{output};
+        writer.appendBson(bytes);
+        REQUIRE_THROWS_AS(writer.appendBson(std::span{bytes}.first(bytes.size() - 1)),
+                          std::invalid_argument);
+        writer.finish();
+    }
+
+    DocumentStore store{file.getName()};
+    REQUIRE(store.size() == 2);
+    REQUIRE(makeDocument(2) == store.getDocument(1).toValue());
+}
+
+TEST_CASE("empty document store", "[document_store]") {
+    TemporaryFile file{"empty.store"};
+    {
+        std::ofstream output{file.getName(), std::ios::binary};
+        DocumentStoreWriter{output}.finish();
+    }
+    DocumentStore store{file.getName()};
+    REQUIRE(store.size() == 0);
+    store.forEach([](BsonView) { FAIL("no documents expected"); });
+}
+
+TEST_CASE("files which are not document stores are rejected", "[document_store]") {
+    TemporaryFile file{"corrupt.store"};
+    {
+        std::ofstream output{file.getName(), std::ios::binary};
+        DocumentStoreWriter writer{output};
+        writer.append(makeDocument(1));
+        writer.finish();
+    }
+    const auto bytes = file.read();
+
+    file.write(bytes.substr(0, bytes.size() - 1));
+    REQUIRE_THROWS_AS(DocumentStore{file.getName()}, std::invalid_argument);
+
+    file.write(bytes.substr(8));
+    REQUIRE_THROWS_AS(DocumentStore{file.getName()}, std::invalid_argument);
+
+    // One more document in the footer than in the index.
+    auto corrupt = bytes;
+    corrupt[bytes.size() - 24] = 2;
+    file.write(corrupt);
+    REQUIRE_THROWS_AS(DocumentStore{file.getName()}, std::invalid_argument);
+
+    // The offset of the document points into the header.
+    corrupt = bytes;
+    corrupt[bytes.size() - 40] = 4;
+    file.write(corrupt);
+    {
+        DocumentStore store{file.getName()};
+        REQUIRE_THROWS_AS(store.getDocument(0), std::invalid_argument);
+    }
+
+    file.write("short");
+    REQUIRE_THROWS_AS(DocumentStore{file.getName()}, std::invalid_argument);
+    REQUIRE_THROWS_AS(DocumentStore{file.getName() + ".missing"}, std::system_error);
+}
+}  // namespace mqlpath
@@ -2,11 +2,27 @@
 
 #include "mqlpath/ast.h"
 #include "mqlpath/error.h"
+#include <utility>
 
 namespace mqlpath {
 
 class Driver {
 public:
+    /**
+     * Makes the parser read a path on its own, as it appears after EvalPath, instead of an
+     * expression. The result is then returned by getPath().
+     */
+    void startWithPath() {
+        _startWithPath = true;
+    }
+
+    /**
+     * Whether the parser should read a path, which holds only until the first token is read.
+     */
+    bool takeStartWithPath() {
+        return std::exchange(_startWithPath, false);
+    }
+
     void setAST(Expression ast) {
         _ast = std::move(ast);
     }
@@ -15,12 +31,22 @@ public:
         return _ast;
     }
 
+    void setPath(Path path) {
+        _path = std::move(path);
+    }
+
+    const Path& getPath() const {
+        return _path;
+    }
+
     ErrorList& getErrors() {
         return _errors;
     }
 
 private:
+    bool _startWithPath{false};
     Expression _ast;
+    Path _path;
     ErrorList _errors;
 };
 }  // namespace mqlpath
\ No newline at end of file
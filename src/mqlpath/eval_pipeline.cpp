@@ -0,0 +1,387 @@
+#include "mqlpath/eval_pipeline.h"
+#include "mqlpath/bounded_queue.h"
+#include "mqlpath/bson.h"
+#include "mqlpath/json.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace mqlpath {
+namespace {
+/**
+ * Unit of work passed along the pipeline. Each stage consumes the fields filled by the previous
+ * one and releases them.
+ */
+struct Batch {
+    size_t sequence{0};
+    // Line of the first document for NDJSON, its number in the stream for BSON and stores.
+    size_t firstDocument{1};
+    std::string input{};
+    // Documents of a store in the batch, starting at 'firstDocument'.
+    size_t storeDocuments{0};
+    std::vector<Value> documents{};
+    std::string jsonOutput{};
+    std::vector<uint8_t> bsonOutput{};
+};
+
+using BatchQueue = BoundedQueue<Batch>;
+
+class Pipeline {
+public:
+    Pipeline(const PreparedPath& path,
+             std::istream* input,
+             const DocumentStore* store,
+             std::ostream& output,
+             const PipelineOptions& options)
+        : _path(path),
+          _input(input),
+          _store(store),
+          _output(output),
+          _options(options),
+          _read(options.queueCapacity),
+          _parsed(options.queueCapacity),
+          _evaluated(options.queueCapacity),
+          _serialized(options.queueCapacity) {}
+
+    void run() {
+        // A thread which fails to start fails the pipeline like a stage error, so that the threads
+        // already running wind down and are joined.
+        try {
+            start();
+            write();
+        } catch (...) {
+            fail(std::current_exception());
+        }
+        for (auto& thread : _threads) {
+            thread.join();
+        }
+        if (_error) {
+            std::rethrow_exception(_error);
+        }
+    }
+
+private:
+    /**
+     * Starts the reader and the workers of every stage.
+     */
+    void start() {
+        _threads.emplace_back([this] {
+            try {
+                if (_store != nullptr) {
+                    readStore();
+                } else if (_options.inputFormat == StreamFormat::Json) {
+                    readJson();
+                } else if (_options.inputFormat == StreamFormat::Bson) {
+                    readBson();
+                } else {
+                    throw std::invalid_argument("a document store can only be read from a file");
+                }
+            } catch (...) {
+                fail(std::current_exception());
+            }
+            _read.close();
+        });
+        startStage(_options.parseWorkers, _read, _parsed, [this](Batch& batch) { parse(batch); });
+        startStage(_options.evalWorkers,
+                   _parsed,
+                   _evaluated,
+                   [this, frames = PathProgram::Frames{}](Batch& batch) mutable {
+                       if (_store != nullptr) {
+                           evaluateStore(batch);
+                           return;
+                       }
+                       for (auto& document : batch.documents) {
+                           document = _path.getProgram().run(std::move(document), frames);
+                       }
+                   });
+        startStage(_options.serializeWorkers, _evaluated, _serialized, [this](Batch& batch) {
+            serialize(batch);
+        });
+    }
+
+    /**
+     * Starts the workers of a stage which apply 'work' to the batches of 'input' and pass them on
+     * to 'output'. Every worker has its own copy of 'work' and the last one to finish closes
+     * 'output'. If a worker fails to start, the exception propagates and the caller fails the
+     * pipeline, which closes 'output' instead.
+     */
+    template <typename Work>
+    void startStage(size_t workerCount, BatchQueue& input, BatchQueue& output, Work work) {
+        workerCount = std::max<size_t>(workerCount, 1);
+        auto running = std::make_shared<std::atomic<size_t>>(workerCount);
+        for (size_t worker = 0; worker < workerCount; ++worker) {
+            _threads.emplace_back([this, &input, &output, running, work]() mutable {
+                try {
+                    while (auto batch = input.pop()) {
+                        work(*batch);
+                        if (!output.push(std::move(*batch))) {
+                            break;
+                        }
+                    }
+                } catch (...) {
+                    fail(std::current_exception());
+                }
+                if (--*running == 0) {
+                    output.close();
+                }
+            });
+        }
+    }
+
+    /**
+     * Records the first error and closes every queue, which lets all stages wind down.
+     */
+    void fail(std::exception_ptr error) {
+        {
+            std::lock_guard lock{_errorMutex};
+            if (!_error) {
+                _error = error;
+            }
+        }
+        _read.close();
+        _parsed.close();
+        _evaluated.close();
+        _serialized.close();
+    }
+
+    /**
+     * Reads about 'batchBytes' bytes at a time and cuts each batch after its last complete line.
+     */
+    void readJson() {
+        std::string pending{};
+        size_t sequence = 0;
+        size_t line = 1;
+        bool atEnd = false;
+        while (!atEnd) {
+            const size_t start = pending.size();
+            pending.resize(start + _options.batchBytes);
+            _input->read(pending.data() + start, static_cast<std::streamsize>(_options.batchBytes));
+            pending.resize(start + static_cast<size_t>(_input->gcount()));
+            checkInput();
+            atEnd = !*_input;
+
+            const size_t end = atEnd ? pending.size() : pending.rfind('\n') + 1;
+            if (end == 0) {
+                continue;
+            }
+            Batch batch{.sequence = sequence++, .firstDocument = line};
+            batch.input = std::move(pending);
+            pending.assign(batch.input, end);
+            batch.input.resize(end);
+            line += std::count(batch.input.begin(), batch.input.end(), '\n');
+            if (!_read.push(std::move(batch))) {
+                return;
+            }
+        }
+    }
+
+    /**
+     * Reads whole documents by their length prefixes until a batch holds 'batchBytes' bytes.
+     */
+    void readBson() {
+        size_t sequence = 0;
+        size_t documentNumber = 1;
+        bool atEnd = false;
+        while (!atEnd) {
+            Batch batch{.sequence = sequence++, .firstDocument = documentNumber};
+            while (batch.input.size() < _options.batchBytes) {
+                int32_t size;
+                _input->read(reinterpret_cast<char*>(&size), sizeof(size));
+                checkInput();
+                if (_input->gcount() == 0) {
+                    atEnd = true;
+                    break;
+                }
+                if (_input->gcount() != sizeof(size) || size < 5) {
+                    throw std::invalid_argument("document " + std::to_string(documentNumber) +
+                                                ": invalid BSON document size");
+                }
+
+                const size_t start = batch.input.size();
+                batch.input.resize(start + static_cast<size_t>(size));
+                std::memcpy(batch.input.data() + start, &size, sizeof(size));
+                _input->read(batch.input.data() + start + sizeof(size), size - sizeof(size));
+                checkInput();
+                if (_input->gcount() != static_cast<std::streamsize>(size - sizeof(size))) {
+                    throw std::invalid_argument("document " + std::to_string(documentNumber) +
+                                                ": truncated BSON document");
+                }
+                ++documentNumber;
+            }
+            if (!batch.input.empty() && !_read.push(std::move(batch))) {
+                return;
+            }
+        }
+    }
+
+    /**
+     * Cuts the store into batches of consecutive documents with about 'batchBytes' bytes. The
+     * documents stay in the mapping and are read by the evaluation workers.
+     */
+    void readStore() {
+        size_t sequence = 0;
+        for (size_t first = 0; first < _store->size();) {
+            size_t last = first;
+            for (size_t bytes = 0; last < _store->size() && bytes < _options.batchBytes; ++last) {
+                bytes += _store->getBytes(last).size();
+            }
+            Batch batch{.sequence = sequence++, .firstDocument = first + 1};
+            batch.storeDocuments = last - first;
+            if (!_read.push(std::move(batch))) {
+                return;
+            }
+            first = last;
+        }
+    }
+
+    void checkInput() {
+        if (_input->bad()) {
+            throw std::runtime_error("failed to read the input");
+        }
+    }
+
+    void parse(Batch& batch) {
+        if (_store != nullptr) {
+            // Store documents are evaluated in place.
+            return;
+        }
+        // Only the parts of the documents which the path reads are built.
+        const auto& projection = _path.getReadSet();
+        if (_options.inputFormat == StreamFormat::Json) {
+            parseNdjson(batch.input, batch.documents, batch.firstDocument, projection);
+        } else {
+            // The reader checked the sizes, so the batch holds complete documents.
+            const auto bytes = reinterpret_cast<const uint8_t*>(batch.input.data());
+            size_t documentNumber = batch.firstDocument;
+            for (size_t offset = 0; offset < batch.input.size(); ++documentNumber) {
+                int32_t size;
+                std::memcpy(&size, bytes + offset, sizeof(size));
+                try {
+                    batch.documents.emplace_back(
+                        BsonView::document({bytes + offset, static_cast<size_t>(size)})
+                            .toValue(projection));
+                } catch (const std::invalid_argument& error) {
+                    throw std::invalid_argument("document " + std::to_string(documentNumber) +
+                                                ": " + error.what());
+                }
+                offset += static_cast<size_t>(size);
+            }
+        }
+        std::string{}.swap(batch.input);
+    }
+
+    void evaluateStore(Batch& batch) {
+        batch.documents.reserve(batch.storeDocuments);
+        size_t documentNumber = batch.firstDocument;
+        _store->forEach(documentNumber - 1,
+                        documentNumber - 1 + batch.storeDocuments,
+                        [&](BsonView document) {
+                            try {
+                                batch.documents.emplace_back(_path.evaluate(document));
+                            } catch (const std::invalid_argument& error) {
+                                throw std::invalid_argument("document " +
+                                                            std::to_string(documentNumber) + ": " +
+                                                            error.what());
+                            }
+                            ++documentNumber;
+                        });
+    }
+
+    void serialize(Batch& batch) {
+        for (const auto& result : batch.documents) {
+            if (_options.outputFormat == StreamFormat::Json) {
+                appendJson(result, batch.jsonOutput);
+                batch.jsonOutput.push_back('\n');
+            } else {
+                appendBson(result, batch.bsonOutput);
+            }
+        }
+        std::vector<Value>{}.swap(batch.documents);
+    }
+
+    /**
+     * Writes the serialized batches in the order they were read. Batches finished out of order
+     * wait until their predecessors were written.
+     */
+    void write() {
+        std::optional<DocumentStoreWriter> storeWriter{};
+        if (_options.outputFormat == StreamFormat::Store) {
+            storeWriter.emplace(_output);
+        }
+        std::map<size_t, Batch> waiting{};
+        size_t next = 0;
+        while (auto batch = _serialized.pop()) {
+            waiting.emplace(batch->sequence, std::move(*batch));
+            for (auto it = waiting.begin(); it != waiting.end() && it->first == next;
+                 it = waiting.erase(it), ++next) {
+                const auto& ready = it->second;
+                if (storeWriter) {
+                    storeWriter->appendBson(ready.bsonOutput);
+                    continue;
+                }
+                _output.write(ready.jsonOutput.data(),
+                              static_cast<std::streamsize>(ready.jsonOutput.size()));
+                _output.write(reinterpret_cast<const char*>(ready.bsonOutput.data()),
+                              static_cast<std::streamsize>(ready.bsonOutput.size()));
+            }
+            if (!_output) {
+                throw std::runtime_error("failed to write the output");
+            }
+        }
+        {
+            std::lock_guard lock{_errorMutex};
+            if (_error) {
+                return;
+            }
+        }
+        if (storeWriter) {
+            storeWriter->finish();
+        }
+        _output.flush();
+    }
+
+    const PreparedPath& _path;
+    std::istream* _input;
+    const DocumentStore* _store;
+    std::ostream& _output;
+    const PipelineOptions& _options;
+
+    BatchQueue _read;
+    BatchQueue _parsed;
+    BatchQueue _evaluated;
+    BatchQueue _serialized;
+    std::vector<std::thread> _threads;
+
+    std::mutex _errorMutex;
+    std::exception_ptr _error;
+};
+}  // namespace
+
+void runPipeline(const PreparedPath& path,
+                 std::istream& input,
+                 std::ostream& output,
+                 const PipelineOptions& options) {
+    Pipeline pipeline{path, &input, nullptr, output, options};
+    pipeline.run();
+}
+
+void runPipeline(const PreparedPath& path,
+                 const DocumentStore& input,
+                 std::ostream& output,
+                 const PipelineOptions& options) {
+    Pipeline pipeline{path, nullptr, &input, output, options};
+    pipeline.run();
+}
+}  // namespace mqlpath
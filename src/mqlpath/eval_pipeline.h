@@ -0,0 +1,62 @@
+#pragma once
+
+#include "mqlpath/document_store.h"
+#include "mqlpath/prepared_path.h"
+#include <cstddef>
+#include <iosfwd>
+#include <thread>
+
+namespace mqlpath {
+enum class StreamFormat {
+    // Newline-delimited JSON, one document per line.
+    Json,
+    // BSON documents back to back.
+    Bson,
+    // DocumentStore file, which is written as a stream but read by mapping it.
+    Store,
+};
+
+struct PipelineOptions {
+    StreamFormat inputFormat{StreamFormat::Json};
+    StreamFormat outputFormat{StreamFormat::Json};
+
+    size_t parseWorkers{1};
+    size_t evalWorkers{std::thread::hardware_concurrency()};
+    size_t serializeWorkers{1};
+
+    // Input bytes read per batch. A batch always ends at a document boundary, so it grows past
+    // this size to hold a larger document.
+    size_t batchBytes{size_t{1} << 20};
+
+    // Batches which may wait between two stages.
+    size_t queueCapacity{8};
+};
+
+/**
+ * Evaluates the path over every document of 'input' and writes the results to 'output' in the
+ * order of their documents. Reading, parsing, evaluation, serialization and writing run as
+ * pipelined stages on their own threads, the middle three with the configured number of workers,
+ * connected by bounded queues of batches. The calling thread writes the output. The parse workers
+ * build only the parts of the documents which the path reads, see PreparedPath::getReadSet().
+ *
+ * NDJSON results are written one per line by appendJson() and BSON results by appendBson(), and
+ * results written as a Store form a DocumentStore. The first error of any stage stops the
+ * pipeline and is rethrown: malformed input throws std::invalid_argument with the line or the
+ * number of the document, a failing stream std::runtime_error and a thread which cannot be started
+ * std::system_error. Results of the batches before the failing one may have been written.
+ */
+void runPipeline(const PreparedPath& path,
+                 std::istream& input,
+                 std::ostream& output,
+                 const PipelineOptions& options = {});
+
+/**
+ * runPipeline() over the documents of a store. There is nothing to parse: the evaluation workers
+ * evaluate the path over the mapped documents in place, so only the results become Values. The
+ * input format of the options is ignored.
+ */
+void runPipeline(const PreparedPath& path,
+                 const DocumentStore& input,
+                 std::ostream& output,
+                 const PipelineOptions& options = {});
+}  // namespace mqlpath
@@ -0,0 +1,121 @@
+#include "mqlpath/ast_make.h"
+#include "mqlpath/bson.h"
+#include "mqlpath/eval_pipeline.h"
+#include "mqlpath/json.h"
+#include "mqlpath/temporary_file.h"
+#include <catch2/catch_test_macros.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace mqlpath {
+namespace {
+std::string makeNdjson(int count) {
+    std::string text{};
+    for (int i = 0; i < count; ++i) {
+        text += R"({"a": )" + std::to_string(i) + R"(, "b": "text )" + std::to_string(i) + "\"}\n";
+    }
+    return text;
+}
+
+std::string runOver(const Path& path, const std::string& input, const PipelineOptions& options) {
+    std::istringstream inputStream{input};
+    std::ostringstream outputStream{};
+    runPipeline(PreparedPath{path}, inputStream, outputStream, options);
+    return outputStream.str();
+}
+}  // namespace
+
+TEST_CASE("pipeline keeps the order of the documents", "[eval_pipeline]") {
+    const int count = 5000;
+    auto input = makeNdjson(count);
+    std::string expected{};
+    for (int i = 0; i < count; ++i) {
+        expected += std::to_string(i) + "\n";
+    }
+
+    // Small batches spread over many workers finish out of order.
+    PipelineOptions options{};
+    options.parseWorkers = 3;
+    options.evalWorkers = 4;
+    options.serializeWorkers = 3;
+    options.batchBytes = 64;
+    options.queueCapacity = 2;
+    REQUIRE(expected == runOver(ast::get("a", ast::id()), input, options));
+
+    options.evalWorkers = 1;
+    options.batchBytes = 1 << 20;
+    REQUIRE(expected == runOver(ast::get("a", ast::id()), input, options));
+}
+
+TEST_CASE("pipeline reads and writes BSON", "[eval_pipeline]") {
+    std::vector<uint8_t> bytes{};
+    for (int32_t i = 0; i < 100; ++i) {
+        appendBson(ast::value(Object{{{"a", ast::value(i)}, {"b", ast::value("x")}}}), bytes);
+    }
+    const std::string input{bytes.begin(), bytes.end()};
+
+    PipelineOptions options{};
+    options.inputFormat = StreamFormat::Bson;
+    options.outputFormat = StreamFormat::Bson;
+    options.batchBytes = 100;
+    auto output = runOver(ast::drop({"b"}), input, options);
+
+    std::vector<uint8_t> expected{};
+    for (int32_t i = 0; i < 100; ++i) {
+        appendBson(ast::value(Object{{{"a", ast::value(i)}}}), expected);
+    }
+    REQUIRE(std::string{expected.begin(), expected.end()} == output);
+
+    options.outputFormat = StreamFormat::Json;
+    output = runOver(ast::get("b", ast::id()), input, options);
+    REQUIRE(output.size() == 400);
+    REQUIRE(output.starts_with("\"x\"\n\"x\"\n"));
+}
+
+TEST_CASE("pipeline writes and reads document stores", "[eval_pipeline]") {
+    TemporaryFile file{"pipeline.store"};
+    PipelineOptions options{};
+    options.outputFormat = StreamFormat::Store;
+    options.batchBytes = 100;
+    file.write(runOver(ast::drop({"b"}), makeNdjson(1000), options));
+
+    DocumentStore store{file.getName()};
+    REQUIRE(store.size() == 1000);
+    REQUIRE(ast::value(Object{{{"a", ast::value(321)}}}) == store.getDocument(321).toValue());
+
+    options.outputFormat = StreamFormat::Json;
+    std::ostringstream output{};
+    runPipeline(PreparedPath{ast::get("a", ast::id())}, store, output, options);
+    std::string expected{};
+    for (int i = 0; i < 1000; ++i) {
+        expected += std::to_string(i) + "\n";
+    }
+    REQUIRE(expected == output.str());
+
+    options.inputFormat = StreamFormat::Store;
+    REQUIRE_THROWS_AS(runOver(ast::id(), "", options), std::invalid_argument);
+}
+
+TEST_CASE("pipeline reports malformed input", "[eval_pipeline]") {
+    PipelineOptions options{};
+    options.batchBytes = 64;
+    auto input = makeNdjson(100) + "{\"a\": \n" + makeNdjson(100);
+    try {
+        runOver(ast::id(), input, options);
+        FAIL("expected an error");
+    } catch (const std::invalid_argument& error) {
+        REQUIRE(std::string{error.what()}.starts_with("line 101: "));
+    }
+
+    options.inputFormat = StreamFormat::Bson;
+    auto bytes = toBson(Object{{{"a", ast::value(1)}}});
+    std::string truncated{bytes.begin(), bytes.end() - 1};
+    REQUIRE_THROWS_AS(runOver(ast::id(), truncated, options), std::invalid_argument);
+}
+
+TEST_CASE("pipeline over empty input writes nothing", "[eval_pipeline]") {
+    REQUIRE(runOver(ast::id(), "", PipelineOptions{}).empty());
+    REQUIRE(runOver(ast::id(), "\n\n", PipelineOptions{}).empty());
+}
+}  // namespace mqlpath
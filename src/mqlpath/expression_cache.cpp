@@ -0,0 +1,112 @@
+#include "mqlpath/expression_cache.h"
+#include "mqlpath/parse.h"
+#include <algorithm>
+#include <cctype>
+
+namespace mqlpath {
+namespace {
+/**
+ * Characters of identifiers, numbers and strings, which must stay apart from their neighbours of
+ * the same kind to keep the tokens apart.
+ */
+bool isWordCharacter(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '.' || c == '-' || c == '"';
+}
+
+// Whitespace as the lexer knows it.
+bool isWhitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\n';
+}
+}  // namespace
+
+ExpressionCache::ExpressionCache(size_t capacity) : _capacity(capacity == 0 ? 1 : capacity) {}
+
+std::shared_ptr<const ExpressionCache::Entry> ExpressionCache::get(std::string_view source) {
+    auto key = normalize(source);
+    {
+        std::lock_guard lock{_mutex};
+        if (auto pos = _index.find(key); pos != _index.end()) {
+            ++_statistics.hits;
+            _entries.splice(_entries.begin(), _entries, pos->second);
+            return pos->second->second;
+        }
+        ++_statistics.misses;
+    }
+
+    // The source rather than the key is parsed, so that errors point into the caller's text.
+    auto expression = parseExpression(std::string{source});
+    std::optional<PreparedPath> path{};
+    if (auto evalPath = expression.cast<EvalPath>(); evalPath != nullptr) {
+        path.emplace(evalPath->path);
+    }
+    auto entry = std::make_shared<const Entry>(Entry{std::move(expression), std::move(path)});
+
+    std::lock_guard lock{_mutex};
+    if (auto pos = _index.find(key); pos != _index.end()) {
+        // Another thread stored the source while this one was parsing it.
+        _entries.splice(_entries.begin(), _entries, pos->second);
+        return pos->second->second;
+    }
+    _entries.emplace_front(std::move(key), entry);
+    _index.emplace(_entries.front().first, _entries.begin());
+    if (_entries.size() > _capacity) {
+        _index.erase(_entries.back().first);
+        _entries.pop_back();
+        ++_statistics.evictions;
+    }
+    return entry;
+}
+
+ExpressionCache::Statistics ExpressionCache::getStatistics() const {
+    std::lock_guard lock{_mutex};
+    auto statistics = _statistics;
+    statistics.size = _entries.size();
+    return statistics;
+}
+
+void ExpressionCache::clear() {
+    std::lock_guard lock{_mutex};
+    _index.clear();
+    _entries.clear();
+}
+
+std::string ExpressionCache::normalize(std::string_view source) {
+    std::string result{};
+    result.reserve(source.size());
+    bool separated = false;
+    for (size_t position = 0; position < source.size();) {
+        const char c = source[position];
+        if (isWhitespace(c)) {
+            separated = true;
+            ++position;
+            continue;
+        }
+        if (c == '/' && position + 1 < source.size() && source[position + 1] == '/') {
+            separated = true;
+            position = std::min(source.find('\n', position), source.size());
+            continue;
+        }
+
+        if (separated && !result.empty() && isWordCharacter(result.back()) && isWordCharacter(c)) {
+            result.push_back(' ');
+        }
+        separated = false;
+
+        if (c != '"') {
+            result.push_back(c);
+            ++position;
+            continue;
+        }
+        // Copies a string literal up to its closing quote or the end of the line.
+        const size_t start = position++;
+        while (position < source.size() && source[position] != '"' && source[position] != '\n') {
+            position += source[position] == '\\' && position + 1 < source.size() ? 2 : 1;
+        }
+        if (position < source.size() && source[position] == '"') {
+            ++position;
+        }
+        result.append(source.substr(start, position - start));
+    }
+    return result;
+}
+}  // namespace mqlpath
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "mqlpath/ast.h"
+#include "mqlpath/prepared_path.h"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace mqlpath {
+/**
+ * Bounded cache of parsed expressions, evicting the least recently used entry once full. The key
+ * is the normalized source (see normalize()), so sources which differ only in whitespace and
+ * comments share an entry. The cache may be used by several threads; entries are immutable and
+ * stay valid after they were evicted for as long as a caller holds them.
+ */
+class ExpressionCache {
+public:
+    struct Entry {
+        Expression expression;
+        // The path of an EvalPath expression, prepared for evaluation over external documents.
+        std::optional<PreparedPath> path;
+    };
+
+    struct Statistics {
+        uint64_t hits{0};
+        uint64_t misses{0};
+        uint64_t evictions{0};
+        size_t size{0};
+    };
+
+    explicit ExpressionCache(size_t capacity);
+
+    /**
+     * Returns the entry of the source, parsing and preparing it on a miss. The parser runs without
+     * holding the cache's lock, so concurrent misses of one source may both parse it but share the
+     * entry which is stored first. Throws std::invalid_argument for an invalid expression, which
+     * is not cached.
+     */
+    std::shared_ptr<const Entry> get(std::string_view source);
+
+    Statistics getStatistics() const;
+
+    void clear();
+
+    /**
+     * Drops comments and whitespace which does not separate tokens, and turns the remaining runs
+     * of whitespace into one space. String literals are kept as they are.
+     */
+    static std::string normalize(std::string_view source);
+
+private:
+    using LruList = std::list<std::pair<std::string, std::shared_ptr<const Entry>>>;
+
+    const size_t _capacity;
+    mutable std::mutex _mutex;
+    // Most recently used first.
+    LruList _entries;
+    std::unordered_map<std::string_view, LruList::iterator> _index;
+    Statistics _statistics;
+};
+}  // namespace mqlpath
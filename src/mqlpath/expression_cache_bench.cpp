@@ -0,0 +1,29 @@
+#include "mqlpath/ast_make.h"
+#include "mqlpath/expression_cache.h"
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+namespace mqlpath {
+TEST_CASE("Cold vs warm expression requests", "[expression_cache][benchmark]") {
+    const std::string source = R"(EvalPath (Field "total" Const 0) * (Drop "tmp", "debug") *
+        (Field "items" Traverse (Keep "sku", "qty")) {items: [{sku: "a", qty: 1}], tmp: 2})";
+    auto document = ast::value(Object{{{"tmp", ast::value(1)}}});
+
+    BENCHMARK("cold: parse and prepare") {
+        ExpressionCache cache{1};
+        return cache.get(source)->path->evaluate(document);
+    };
+
+    ExpressionCache cache{16};
+    cache.get(source);
+    BENCHMARK("warm: cache hit") {
+        return cache.get(source)->path->evaluate(document);
+    };
+
+    const std::string reformatted = "  " + source + "  // reformatted\n";
+    BENCHMARK("warm: cache hit after normalization") {
+        return cache.get(reformatted)->path->evaluate(document);
+    };
+}
+}  // namespace mqlpath
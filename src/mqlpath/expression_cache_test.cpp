@@ -0,0 +1,105 @@
+#include "mqlpath/ast_eval.h"
+#include "mqlpath/ast_make.h"
+#include "mqlpath/expression_cache.h"
+#include <catch2/catch_test_macros.hpp>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace mqlpath {
+TEST_CASE("expression source normalization", "[expression_cache]") {
+    REQUIRE(ExpressionCache::normalize("  EvalPath   Get \"a\"\n\tId  {a: 1} ") ==
+            "EvalPath Get \"a\" Id{a:1}");
+    REQUIRE(ExpressionCache::normalize("EvalPath (Get \"a\" Id) // comment\n [ 1 , 2 ]") ==
+            "EvalPath(Get \"a\" Id)[1,2]");
+    // Adjacent strings would lex as one string with a doubled quote.
+    REQUIRE(ExpressionCache::normalize("Drop \"a\"  ,  \"b\"") == "Drop \"a\",\"b\"");
+    REQUIRE(ExpressionCache::normalize("[\"a\"   \"b\"]") == "[\"a\" \"b\"]");
+    // String literals keep their whitespace and anything which looks like a comment.
+    REQUIRE(ExpressionCache::normalize("\"a  // b \\\" c\"  1") == "\"a  // b \\\" c\" 1");
+    // Carriage returns are not whitespace to the lexer.
+    REQUIRE(ExpressionCache::normalize("1\r") == "1\r");
+}
+
+TEST_CASE("expression cache shares entries of equivalent sources", "[expression_cache]") {
+    ExpressionCache cache{4};
+    auto first = cache.get("EvalPath Get \"a\" Id {a: 5}");
+    auto second = cache.get("EvalPath  Get \"a\"  Id\n{a:5} // the same");
+    REQUIRE(first == second);
+    REQUIRE(first->path.has_value());
+    REQUIRE(ast::value(5) == evaluate(first->expression));
+    REQUIRE(ast::value(5) == first->path->evaluate(ast::value(Object{{{"a", ast::value(5)}}})));
+
+    auto constant = cache.get("[1, 2]");
+    REQUIRE(!constant->path.has_value());
+    REQUIRE(ast::value(std::vector<int32_t>{1, 2}) == evaluate(constant->expression));
+
+    auto statistics = cache.getStatistics();
+    REQUIRE(statistics.hits == 1);
+    REQUIRE(statistics.misses == 2);
+    REQUIRE(statistics.evictions == 0);
+    REQUIRE(statistics.size == 2);
+}
+
+TEST_CASE("expression cache evicts the least recently used entry", "[expression_cache]") {
+    ExpressionCache cache{2};
+    auto one = cache.get("1");
+    cache.get("2");
+    cache.get("1");
+    cache.get("3");
+
+    auto statistics = cache.getStatistics();
+    REQUIRE(statistics.evictions == 1);
+    REQUIRE(statistics.size == 2);
+
+    // "2" was evicted, "1" stayed.
+    REQUIRE(cache.get("1") == one);
+    REQUIRE(cache.getStatistics().misses == 3);
+    cache.get("2");
+    REQUIRE(cache.getStatistics().misses == 4);
+
+    // Evicted entries stay valid for their holders.
+    cache.clear();
+    REQUIRE(cache.getStatistics().size == 0);
+    REQUIRE(ast::value(1) == evaluate(one->expression));
+}
+
+TEST_CASE("expression cache does not store invalid expressions", "[expression_cache]") {
+    ExpressionCache cache{2};
+    REQUIRE_THROWS_AS(cache.get("EvalPath Get Id"), std::invalid_argument);
+    REQUIRE(cache.getStatistics().size == 0);
+
+    // Errors point into the source, not into its normalized form.
+    std::string message{};
+    try {
+        cache.get("// A path.\nEvalPath  Get a  Id  1]");
+    } catch (const std::invalid_argument& error) {
+        message = error.what();
+    }
+    REQUIRE(message ==
+            "1 errors.\n[parser] :2.23: syntax error, unexpected ']', expecting end of file\n");
+}
+
+TEST_CASE("expression cache is shared by threads", "[expression_cache]") {
+    ExpressionCache cache{8};
+    std::vector<std::thread> threads{};
+    std::vector<int> failures(4, 0);
+    for (int thread = 0; thread < 4; ++thread) {
+        threads.emplace_back([&, thread] {
+            for (int i = 0; i < 200; ++i) {
+                const int32_t number = (i + thread) % 12;
+                auto entry = cache.get(std::to_string(number));
+                failures[thread] += !(ast::value(number) == evaluate(entry->expression));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(failures == std::vector<int>(4, 0));
+    auto statistics = cache.getStatistics();
+    REQUIRE(statistics.hits + statistics.misses == 800);
+    REQUIRE(statistics.size <= 8);
+}
+}  // namespace mqlpath
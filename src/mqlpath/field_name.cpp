@@ -0,0 +1,116 @@
+#include "mqlpath/field_name.h"
+#include <array>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace mqlpath {
+namespace {
+class AtomTable {
+public:
+    const FieldName::Entry* find(std::string_view name, size_t hash) {
+        std::shared_lock lock{_mutex};
+        if (auto pos = _entries.find(name); pos != _entries.end()) {
+            return pos->second.get();
+        }
+        // Counted under the lock, so that an atom of the same name which is created afterwards
+        // sees the count.
+        addPlain(hash);
+        return nullptr;
+    }
+
+    const FieldName::Entry* intern(std::string_view name) {
+        {
+            std::shared_lock lock{_mutex};
+            if (auto pos = _entries.find(name); pos != _entries.end()) {
+                return pos->second.get();
+            }
+        }
+
+        const size_t hash = std::hash<std::string_view>{}(name);
+        std::unique_lock lock{_mutex};
+        if (auto pos = _entries.find(name); pos != _entries.end()) {
+            return pos->second.get();
+        }
+        const bool late = _plainNames[hash % kPlainBuckets].load() != 0;
+        // The key views the entry's own copy of the name, which outlives the caller's buffer.
+        auto entry = std::make_unique<FieldName::Entry>(std::string{name}, hash, late);
+        auto result = entry.get();
+        _entries.emplace(result->name, std::move(entry));
+        return result;
+    }
+
+    void addPlain(size_t hash) {
+        _plainNames[hash % kPlainBuckets].fetch_add(1);
+    }
+
+    void removePlain(size_t hash) {
+        _plainNames[hash % kPlainBuckets].fetch_sub(1, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr size_t kPlainBuckets = 4096;
+
+    std::shared_mutex _mutex;
+    std::unordered_map<std::string_view, std::unique_ptr<FieldName::Entry>> _entries;
+    // Live plain names by their hash, in a fixed number of buckets so that ever new keys take no
+    // memory. Atoms whose bucket is not empty may equal a plain name.
+    std::array<std::atomic<uint32_t>, kPlainBuckets> _plainNames{};
+};
+
+AtomTable& atomTable() {
+    static AtomTable table{};
+    return table;
+}
+}  // namespace
+
+FieldName::FieldName() : _bits(emptyBits()) {}
+
+FieldName::FieldName(std::string_view name)
+    : _bits(reinterpret_cast<uintptr_t>(atomTable().intern(name))) {}
+
+FieldName FieldName::fromKey(std::string_view name) {
+    FieldName result{};
+    const size_t hash = std::hash<std::string_view>{}(name);
+    if (auto atom = atomTable().find(name, hash); atom != nullptr) {
+        result._bits = reinterpret_cast<uintptr_t>(atom);
+    } else {
+        auto entry = new Entry{std::string{name}, hash, false};
+        result._bits = reinterpret_cast<uintptr_t>(entry) | kPlain;
+    }
+    return result;
+}
+
+uintptr_t FieldName::emptyBits() {
+    static const uintptr_t empty = reinterpret_cast<uintptr_t>(atomTable().intern({}));
+    return empty;
+}
+
+bool FieldName::equals(const FieldName& other) const {
+    return hash() == other.hash() && str() == other.str();
+}
+
+void FieldName::release() {
+    if (entry()->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        atomTable().removePlain(hash());
+        delete entry();
+    }
+}
+
+FieldName FieldNameCache::get(std::string_view key) {
+    if (auto pos = _names.find(key); pos != _names.end()) {
+        return pos->second;
+    }
+    auto name = FieldName::fromKey(key);
+    const std::string_view view = name.str();
+    return _names.emplace(view, std::move(name)).first->second;
+}
+
+std::ostream& operator<<(std::ostream& os, const FieldName& fieldName) {
+    os << fieldName.str();
+    return os;
+}
+}  // namespace mqlpath
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace mqlpath {
+/**
+ * Field name, most often an atom: equal atoms share one entry of the process-wide atom table, so
+ * comparing them is a pointer comparison and their hash is computed only once. The names built
+ * from strings, those of paths, literals and code, are atoms. The table is thread-safe and never
+ * shrinks, so it only holds names which programs spell out.
+ *
+ * Keys read from documents (see fromKey()) are only atoms if the atom already exists. The others
+ * are plain names with an entry of their own, which is freed with their last copy, so that
+ * reading documents with ever new keys, such as IDs or timestamps, does not grow the table.
+ * Names compare by content as soon as one of them is plain.
+ */
+class FieldName {
+public:
+    FieldName();
+    FieldName(std::string_view name);
+    FieldName(const std::string& name) : FieldName(std::string_view{name}) {}
+    FieldName(const char* name) : FieldName(std::string_view{name}) {}
+
+    FieldName(const FieldName& other) noexcept : _bits(other._bits) {
+        if (isPlain()) {
+            entry()->references.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    FieldName(FieldName&& other) noexcept : _bits(other._bits) {
+        if (isPlain()) {
+            other._bits = emptyBits();
+        }
+    }
+
+    FieldName& operator=(FieldName other) noexcept {
+        std::swap(_bits, other._bits);
+        return *this;
+    }
+
+    ~FieldName() {
+        if (isPlain()) {
+            release();
+        }
+    }
+
+    /**
+     * The name of a key read from a document: its atom if there is one, a plain name otherwise.
+     */
+    static FieldName fromKey(std::string_view name);
+
+    const std::string& str() const {
+        return entry()->name;
+    }
+
+    size_t hash() const {
+        return entry()->hash;
+    }
+
+    bool operator==(const FieldName& other) const {
+        return _bits == other._bits || (((_bits | other._bits) & kPlain) != 0 && equals(other));
+    }
+
+    /**
+     * Whether equal names are all the same atom, so that a pointer comparison finds them. This
+     * does not hold for plain names, nor for atoms created while plain names of the same content
+     * may be alive.
+     */
+    bool isUnique() const {
+        return !isPlain() && !entry()->late;
+    }
+
+    /**
+     * The entry of the name, with the lowest bit set for plain names.
+     */
+    uintptr_t bits() const {
+        return _bits;
+    }
+
+    struct Entry {
+        Entry(std::string name, size_t hash, bool late)
+            : name(std::move(name)), hash(hash), late(late) {}
+
+        std::string name;
+        size_t hash;
+        // Whether plain names of the same content may have been alive when the atom was created.
+        bool late;
+        // Copies of a plain name, unused for atoms which live as long as the process.
+        mutable std::atomic<size_t> references{1};
+    };
+
+private:
+    static constexpr uintptr_t kPlain = 1;
+
+    static uintptr_t emptyBits();
+
+    bool isPlain() const {
+        return (_bits & kPlain) != 0;
+    }
+
+    const Entry* entry() const {
+        return reinterpret_cast<const Entry*>(_bits & ~kPlain);
+    }
+
+    bool equals(const FieldName& other) const;
+
+    void release();
+
+    uintptr_t _bits;
+};
+
+/**
+ * Names of the keys read by one reader, which looks up the atom table, and allocates plain names,
+ * only once per distinct key instead of once per key of every document. Not thread-safe: every
+ * reader has its own. Its plain names are freed with the cache and the values which use them.
+ */
+class FieldNameCache {
+public:
+    FieldName get(std::string_view key);
+
+private:
+    // The keys view the names' own strings.
+    std::unordered_map<std::string_view, FieldName> _names;
+};
+
+static_assert(sizeof(FieldName) == sizeof(uint64_t) && std::is_standard_layout_v<FieldName>,
+              "findFieldName compares names as 64-bit words");
+
+#if defined(__SSE2__)
+namespace detail {
+/**
+ * Bit mask of the two names in 'block' which are equal to 'needle'. SSE2 has no 64-bit equality,
+ * so both 32-bit halves of a name must match.
+ */
+inline int matchNames(__m128i block, __m128i needle) {
+    const __m128i halves = _mm_cmpeq_epi32(block, needle);
+    const __m128i both =
+        _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_movemask_pd(_mm_castsi128_pd(both));
+}
+}  // namespace detail
+#endif
+
+/**
+ * Returns the position of the first of the 'size' names equal to 'fieldName', or 'size' if there
+ * is none. Unique atoms are found by comparing pointers, four at a time where SSE2 is available,
+ * while other names are compared one by one.
+ */
+inline size_t findFieldName(const FieldName* names, size_t size, const FieldName& fieldName) {
+    size_t position = 0;
+    if (!fieldName.isUnique()) {
+        for (; position < size; ++position) {
+            if (names[position] == fieldName) {
+                return position;
+            }
+        }
+        return size;
+    }
+#if defined(__SSE2__)
+    const __m128i needle = _mm_set1_epi64x(static_cast<int64_t>(fieldName.bits()));
+    for (; position + 4 <= size; position += 4) {
+        const auto block = reinterpret_cast<const __m128i*>(names + position);
+        const int matches = detail::matchNames(_mm_loadu_si128(block), needle) |
+            (detail::matchNames(_mm_loadu_si128(block + 1), needle) << 2);
+        if (matches != 0) {
+            return position + std::countr_zero(static_cast<unsigned>(matches));
+        }
+    }
+#endif
+    for (; position < size; ++position) {
+        if (names[position].bits() == fieldName.bits()) {
+            return position;
+        }
+    }
+    return size;
+}
+
+std::ostream& operator<<(std::ostream& os, const FieldName& fieldName);
+}  // namespace mqlpath
+
+template <>
+struct std::hash<mqlpath::FieldName> {
+    size_t operator()(const mqlpath::FieldName& fieldName) const noexcept {
+        return fieldName.hash();
+    }
+};
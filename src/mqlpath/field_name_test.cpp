@@ -0,0 +1,123 @@
+#include "mqlpath/field_name.h"
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mqlpath {
+TEST_CASE("equal field names share the atom", "[field_name]") {
+    std::string name{"hello"};
+    FieldName first{name};
+    FieldName second{"hello"};
+
+    REQUIRE(first == second);
+    REQUIRE(&first.str() == &second.str());
+    REQUIRE(first.hash() == second.hash());
+    REQUIRE(first.str() == "hello");
+}
+
+TEST_CASE("different field names are different atoms", "[field_name]") {
+    REQUIRE(!(FieldName{"a"} == FieldName{"b"}));
+    REQUIRE(!(FieldName{"a"} == FieldName{"a.b"}));
+    REQUIRE(FieldName{} == FieldName{""});
+}
+
+TEST_CASE("field names interned concurrently share the atom", "[field_name]") {
+    const size_t threadCount = 4;
+    std::vector<std::vector<FieldName>> names(threadCount);
+    std::vector<std::thread> threads{};
+    for (size_t t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&names, t]() {
+            for (int i = 0; i < 1000; ++i) {
+                names[t].emplace_back("concurrent" + std::to_string(i));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (size_t t = 1; t < threadCount; ++t) {
+        REQUIRE(names[0] == names[t]);
+    }
+}
+
+TEST_CASE("findFieldName returns the first matching position", "[field_name]") {
+    std::vector<FieldName> names{};
+    for (size_t i = 0; i < 11; ++i) {
+        names.emplace_back("n" + std::to_string(i % 10));
+    }
+
+    for (size_t size = 0; size <= names.size(); ++size) {
+        for (size_t i = 0; i < 10; ++i) {
+            const auto expected = i < size ? i : size;
+            REQUIRE(findFieldName(names.data(), size, names[i]) == expected);
+        }
+        REQUIRE(findFieldName(names.data(), size, "missing") == size);
+    }
+    // "n0" appears at positions 0 and 10.
+    REQUIRE(findFieldName(names.data() + 1, 10, "n0") == 9);
+}
+
+TEST_CASE("keys use the existing atom", "[field_name]") {
+    FieldName atom{"keyAtom"};
+    auto key = FieldName::fromKey("keyAtom");
+
+    REQUIRE(key == atom);
+    REQUIRE(key.bits() == atom.bits());
+    REQUIRE(key.isUnique());
+}
+
+TEST_CASE("keys without an atom are plain names equal by content", "[field_name]") {
+    auto key = FieldName::fromKey("plainKey");
+    auto copy = key;
+    REQUIRE(!key.isUnique());
+    REQUIRE(copy.bits() == key.bits());
+    REQUIRE(key == FieldName::fromKey("plainKey"));
+    REQUIRE(key.bits() != FieldName::fromKey("plainKey").bits());
+    REQUIRE(!(key == FieldName::fromKey("otherPlainKey")));
+    REQUIRE(key.str() == "plainKey");
+
+    // The atom created afterwards is not unique, so lookups also compare it by content.
+    FieldName atom{"plainKey"};
+    REQUIRE(!atom.isUnique());
+    REQUIRE(atom == key);
+    REQUIRE(key == atom);
+    REQUIRE(atom.hash() == key.hash());
+
+    std::vector<FieldName> names{"k0", "k1", "k2", "k3", "k4", key};
+    REQUIRE(findFieldName(names.data(), names.size(), atom) == 5);
+    REQUIRE(findFieldName(names.data(), names.size(), FieldName::fromKey("plainKey")) == 5);
+    REQUIRE(findFieldName(names.data(), names.size(), "k4") == 4);
+
+    auto moved = std::move(copy);
+    REQUIRE(moved == key);
+    REQUIRE(copy == FieldName{});
+    copy = moved;
+    REQUIRE(copy == key);
+}
+
+TEST_CASE("atoms created after reading other keys are unique", "[field_name]") {
+    std::vector<FieldName> keys{};
+    for (int i = 0; i < 10; ++i) {
+        keys.push_back(FieldName::fromKey("readKey" + std::to_string(i)));
+    }
+    FieldName atom{"atomAfterKeys"};
+    REQUIRE(atom.isUnique());
+
+    // Once the plain names are freed, their atoms are unique again.
+    keys.clear();
+    FieldName freed{"readKey0"};
+    REQUIRE(freed.isUnique());
+}
+
+TEST_CASE("a cache returns one name per key", "[field_name]") {
+    FieldNameCache cache{};
+    FieldName atom{"cachedAtom"};
+    auto plain = cache.get("cachedPlain");
+
+    REQUIRE(cache.get("cachedPlain").bits() == plain.bits());
+    REQUIRE(cache.get("cachedAtom").bits() == atom.bits());
+    REQUIRE(plain.str() == "cachedPlain");
+}
+}  // namespace mqlpath
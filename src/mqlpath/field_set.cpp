@@ -0,0 +1,160 @@
+#include "mqlpath/field_set.h"
+#include <ostream>
+#include <utility>
+
+namespace mqlpath {
+namespace {
+const FieldSet kEmpty{};
+const FieldSet kAll = FieldSet::all();
+}  // namespace
+
+const FieldSet& FieldSet::getField(const FieldName& fieldName) const {
+    if (_kind != Kind::Projection) {
+        return _kind == Kind::All ? kAll : kEmpty;
+    }
+    const size_t position = findFieldName(_names.data(), _names.size(), fieldName);
+    if (position != _names.size()) {
+        return _sets[position];
+    }
+    return _otherFields ? kAll : kEmpty;
+}
+
+const FieldSet& FieldSet::getElements() const {
+    if (_kind != Kind::Projection) {
+        return _kind == Kind::All ? kAll : kEmpty;
+    }
+    return _elements != nullptr ? *_elements : kEmpty;
+}
+
+void FieldSet::setField(const FieldName& fieldName, FieldSet set) {
+    makeProjection();
+    // Fields whose set is the same as that of the other fields are not listed.
+    const bool listed = _otherFields ? !set.isAll() : !set.isEmpty();
+    const size_t position = findFieldName(_names.data(), _names.size(), fieldName);
+    if (position == _names.size()) {
+        if (listed) {
+            _names.push_back(fieldName);
+            _sets.emplace_back(std::move(set));
+        }
+    } else if (listed) {
+        _sets[position] = std::move(set);
+    } else {
+        _names.erase(_names.begin() + position);
+        _sets.erase(_sets.begin() + position);
+    }
+    simplify();
+}
+
+void FieldSet::setElements(FieldSet set) {
+    makeProjection();
+    _elements = set.isEmpty() ? nullptr : std::make_shared<const FieldSet>(std::move(set));
+    simplify();
+}
+
+void FieldSet::unite(const FieldSet& other) {
+    if (other.isEmpty() || isAll()) {
+        return;
+    }
+    if (isEmpty() || other.isAll()) {
+        *this = other;
+        return;
+    }
+
+    // Both are projections: unite the sets of every field listed by either of them, which are
+    // computed before _otherFields changes their defaults.
+    std::vector<FieldName> names = _names;
+    for (const auto& fieldName : other._names) {
+        if (findFieldName(names.data(), names.size(), fieldName) == names.size()) {
+            names.push_back(fieldName);
+        }
+    }
+    std::vector<FieldSet> sets{};
+    sets.reserve(names.size());
+    for (const auto& fieldName : names) {
+        sets.emplace_back(getField(fieldName));
+        sets.back().unite(other.getField(fieldName));
+    }
+    auto elements = getElements();
+    elements.unite(other.getElements());
+
+    _otherFields = _otherFields || other._otherFields;
+    _names.clear();
+    _sets.clear();
+    for (size_t position = 0; position < names.size(); ++position) {
+        setField(names[position], std::move(sets[position]));
+    }
+    setElements(std::move(elements));
+}
+
+Value FieldSet::project(const Value& value) const {
+    if (isEmpty()) {
+        return Value::make<NothingValue>();
+    }
+    if (isAll()) {
+        return value;
+    }
+
+    if (auto objectValue = value.cast<ObjectValue>(); objectValue != nullptr) {
+        const auto& names = objectValue->object.getNames();
+        const auto& values = objectValue->object.getValues();
+        Object::Fields fields{};
+        for (size_t position = 0; position < names.size(); ++position) {
+            const auto& set = getField(names[position]);
+            if (!set.isEmpty()) {
+                fields.emplace_back(names[position], set.project(values[position]));
+            }
+        }
+        return Value::make<ObjectValue>(Object{std::move(fields)});
+    }
+    if (auto arrayValue = value.cast<ArrayValue>(); arrayValue != nullptr) {
+        const auto& elements = getElements();
+        Array result{};
+        if (!elements.isEmpty()) {
+            result.reserve(arrayValue->array.size());
+            for (const auto& element : arrayValue->array) {
+                result.emplace_back(elements.project(element));
+            }
+        }
+        return Value::make<ArrayValue>(std::move(result));
+    }
+    return value;
+}
+
+void FieldSet::makeProjection() {
+    if (_kind == Kind::All) {
+        _otherFields = true;
+        _elements = std::make_shared<const FieldSet>(kAll);
+    }
+    _kind = Kind::Projection;
+}
+
+void FieldSet::simplify() {
+    if (_kind == Kind::Projection && _otherFields && _names.empty() && _elements != nullptr &&
+        _elements->isAll()) {
+        *this = all();
+    }
+}
+
+std::ostream& operator<<(std::ostream& os, const FieldSet& set) {
+    if (set.isEmpty()) {
+        return os << "none";
+    }
+    if (set.isAll()) {
+        return os << "all";
+    }
+    os << "{";
+    const char* separator = "";
+    for (size_t position = 0; position < set._names.size(); ++position) {
+        os << separator << set._names[position] << ": " << set._sets[position];
+        separator = ", ";
+    }
+    if (set._otherFields) {
+        os << separator << "*: all";
+        separator = ", ";
+    }
+    if (set._elements != nullptr) {
+        os << separator << "[]: " << *set._elements;
+    }
+    return os << "}";
+}
+}  // namespace mqlpath
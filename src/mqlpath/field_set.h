@@ -0,0 +1,111 @@
+#pragma once
+
+#include "mqlpath/field_name.h"
+#include "mqlpath/value.h"
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <vector>
+
+namespace mqlpath {
+/**
+ * Set of the parts of a value, e.g. those a path reads. A set is empty, the whole value, or a
+ * projection: the fields of an object which are listed in it each have their own set, and its
+ * other fields are either all whole or all left out; the elements of an array share one set.
+ * A projection keeps a value's type and the whole of a scalar, so a projected object stays an
+ * object even if none of its fields are left, and a projected array stays an array.
+ */
+class FieldSet {
+public:
+    /**
+     * The empty set.
+     */
+    FieldSet() = default;
+
+    static FieldSet all() {
+        return FieldSet{Kind::All};
+    }
+
+    /**
+     * Projection which keeps no fields and no elements, only the type of the value and scalars.
+     */
+    static FieldSet shape() {
+        return FieldSet{Kind::Projection};
+    }
+
+    /**
+     * Projection which keeps the fields not listed by setField() whole, and no elements.
+     */
+    static FieldSet otherFields() {
+        FieldSet result{Kind::Projection};
+        result._otherFields = true;
+        return result;
+    }
+
+    bool isEmpty() const {
+        return _kind == Kind::Empty;
+    }
+
+    bool isAll() const {
+        return _kind == Kind::All;
+    }
+
+    /**
+     * The set of the field of an object.
+     */
+    const FieldSet& getField(const FieldName& fieldName) const;
+
+    /**
+     * The set of every element of an array.
+     */
+    const FieldSet& getElements() const;
+
+    /**
+     * Sets the set of the field of an object, making this set a projection.
+     */
+    void setField(const FieldName& fieldName, FieldSet set);
+
+    /**
+     * Sets the set of every element of an array, making this set a projection.
+     */
+    void setElements(FieldSet set);
+
+    /**
+     * Adds the parts of 'other' to this set.
+     */
+    void unite(const FieldSet& other);
+
+    /**
+     * The parts of the value which are in this set. Nothing stays Nothing, an empty set yields
+     * Nothing as well.
+     */
+    Value project(const Value& value) const;
+
+    friend std::ostream& operator<<(std::ostream& os, const FieldSet& set);
+
+private:
+    enum class Kind : uint8_t { Empty, All, Projection };
+
+    explicit FieldSet(Kind kind) : _kind(kind) {}
+
+    /**
+     * Turns the set into a projection so that parts of it can be changed: the whole value into the
+     * equivalent otherFields() with whole elements, the empty set into shape().
+     */
+    void makeProjection();
+
+    /**
+     * Turns a projection which keeps everything into all().
+     */
+    void simplify();
+
+    Kind _kind{Kind::Empty};
+    // Whether the fields of a projection which are not listed in _names are whole.
+    bool _otherFields{false};
+    // The listed fields and their sets, which differ from those of the other fields.
+    std::vector<FieldName> _names;
+    std::vector<FieldSet> _sets;
+    // Shared as sets are copied while they are built; null if no elements are kept.
+    std::shared_ptr<const FieldSet> _elements;
+};
+}  // namespace mqlpath
@@ -0,0 +1,112 @@
+#include "mqlpath/ast_make.h"
+#include "mqlpath/field_set.h"
+#include <catch2/catch_test_macros.hpp>
+#include <sstream>
+
+namespace mqlpath {
+namespace {
+std::string toString(const FieldSet& set) {
+    std::ostringstream os;
+    os << set;
+    return os.str();
+}
+
+FieldSet fieldSet(const FieldName& fieldName, FieldSet set) {
+    auto result = FieldSet::shape();
+    result.setField(fieldName, std::move(set));
+    return result;
+}
+}  // namespace
+
+TEST_CASE("field sets list the fields which differ from the others", "[field_set]") {
+    REQUIRE(toString(FieldSet{}) == "none");
+    REQUIRE(toString(FieldSet::all()) == "all");
+    REQUIRE(toString(FieldSet::shape()) == "{}");
+
+    auto set = fieldSet("a", FieldSet::all());
+    set.setField("b", FieldSet{});
+    REQUIRE(toString(set) == "{a: all}");
+    REQUIRE(set.getField("a").isAll());
+    REQUIRE(set.getField("b").isEmpty());
+    REQUIRE(set.getElements().isEmpty());
+
+    auto others = FieldSet::otherFields();
+    others.setField("a", FieldSet::all());
+    others.setField("b", FieldSet{});
+    REQUIRE(toString(others) == "{b: none, *: all}");
+    REQUIRE(others.getField("c").isAll());
+
+    // Excluding a field from the whole value keeps the elements whole.
+    auto all = FieldSet::all();
+    all.setField("a", FieldSet::shape());
+    REQUIRE(toString(all) == "{a: {}, *: all, []: all}");
+    all.setField("a", FieldSet::all());
+    REQUIRE(all.isAll());
+}
+
+TEST_CASE("field sets unite field by field", "[field_set]") {
+    auto set = fieldSet("a", FieldSet::all());
+    set.unite(fieldSet("b", fieldSet("c", FieldSet::all())));
+    REQUIRE(toString(set) == "{a: all, b: {c: all}}");
+
+    set.unite(fieldSet("b", fieldSet("d", FieldSet::shape())));
+    REQUIRE(toString(set) == "{a: all, b: {c: all, d: {}}}");
+
+    auto elements = FieldSet::shape();
+    elements.setElements(fieldSet("e", FieldSet::all()));
+    set.unite(elements);
+    REQUIRE(toString(set) == "{a: all, b: {c: all, d: {}}, []: {e: all}}");
+
+    auto others = FieldSet::otherFields();
+    others.setField("a", FieldSet{});
+    others.setField("b", fieldSet("x", FieldSet::all()));
+    others.unite(set);
+    REQUIRE(toString(others) == "{b: {x: all, c: all, d: {}}, *: all, []: {e: all}}");
+
+    auto empty = FieldSet{};
+    empty.unite(set);
+    REQUIRE(toString(empty) == toString(set));
+    set.unite(FieldSet::all());
+    REQUIRE(set.isAll());
+}
+
+TEST_CASE("projections keep the types of values", "[field_set]") {
+    auto document = ast::value(Object{{
+        {"a", ast::value(1)},
+        {"b", ast::value(Object{{{"c", ast::value(2)}, {"d", ast::value(3)}}})},
+        {"e", Value::make<ArrayValue>(std::vector<Value>{
+                  ast::value(Object{{{"c", ast::value(4)}, {"d", ast::value(5)}}}),
+                  ast::value(6)})},
+    }});
+
+    REQUIRE(FieldSet::all().project(document) == document);
+    REQUIRE(FieldSet{}.project(document) == ast::nothing());
+    REQUIRE(FieldSet::shape().project(document) == ast::value(Object{}));
+    REQUIRE(FieldSet::shape().project(ast::value(1)) == ast::value(1));
+
+    auto set = fieldSet("b", fieldSet("c", FieldSet::all()));
+    set.setField("e", FieldSet::shape());
+    REQUIRE(set.project(document) == ast::value(Object{{
+                                         {"b", ast::value(Object{{{"c", ast::value(2)}}})},
+                                         {"e", ast::value(std::vector<int32_t>{})},
+                                     }}));
+
+    auto elements = FieldSet::otherFields();
+    elements.setField("b", FieldSet{});
+    elements.setElements(fieldSet("d", FieldSet::all()));
+    REQUIRE(elements.project(document) ==
+            ast::value(Object{{
+                {"a", ast::value(1)},
+                {"e", Value::make<ArrayValue>(std::vector<Value>{
+                          ast::value(Object{{{"c", ast::value(4)}, {"d", ast::value(5)}}}),
+                          ast::value(6)})},
+            }}));
+    set.setField("e", elements);
+    REQUIRE(set.project(document) ==
+            ast::value(Object{{
+                {"b", ast::value(Object{{{"c", ast::value(2)}}})},
+                {"e", Value::make<ArrayValue>(std::vector<Value>{
+                          ast::value(Object{{{"d", ast::value(5)}}}), ast::value(6)})},
+            }}));
+}
+}  // namespace mqlpath
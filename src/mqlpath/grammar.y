@@ -18,6 +18,7 @@
 %code requires{
 #include <mqlpath/value.h>
 #include <mqlpath/driver.h>
+#include <string_view>
 
 namespace mqlpath { class Lexer; }
 }
@@ -28,38 +29,77 @@ namespace mqlpath { class Lexer; }
 %code{
   #include "lexer.h"
   #undef yylex
-  #define yylex lexer.lex
+  #define yylex(driver) nextToken(lexer, driver)
+
+  #include <mqlpath/numbers.h>
+  #include <charconv>
+  #include <type_traits>
+
+  namespace {
+  /**
+   * The next token of the input, preceded by PATH_START when the driver asks for a bare path.
+   */
+  mqlpath::Parser::symbol_type nextToken(mqlpath::Lexer& lexer, mqlpath::Driver* driver) {
+    if (driver->takeStartWithPath()) {
+      return mqlpath::Parser::make_PATH_START(mqlpath::location{});
+    }
+    return lexer.lex(driver);
+  }
+
+  /**
+   * Converts the text of a number token, which the lexer has already matched, throwing a syntax
+   * error if the number cannot be represented. Doubles too small to represent are rounded to zero.
+   */
+  template <typename Number>
+  Number toNumber(std::string_view text, const mqlpath::location& location) {
+    Number number{};
+    const char* last = text.data() + text.size();
+    std::from_chars_result result;
+    if constexpr (std::is_same_v<Number, double>) {
+      result = mqlpath::parseDouble(text.data(), last, number);
+    } else {
+      result = std::from_chars(text.data(), last, number);
+    }
+    if (result.ec != std::errc{} || result.ptr != last) {
+      throw mqlpath::Parser::syntax_error(location, "Number out of range " + std::string{text});
+    }
+    return number;
+  }
+  }  // namespace
 }
 
 %define api.token.prefix {TOK_}
 %token EOF 0 "end of file"
-%token <std::string> INTEGER "integer"
-%token <std::string> FLOAT "float"
-%token <std::string> STRING "string"
+%token <std::string_view> INTEGER "integer"
+%token <std::string_view> FLOAT "float"
+%token <std::string_view> STRING "string"
 %token <bool> BOOLEAN "boolean"
-%token <std::string> IDENTIFIER "identifier"
+%token <std::string_view> IDENTIFIER "identifier"
 %token NOTHING 
 %token EVALPATH 
 %token ID CONST DEFAULT LAMBDA DROP KEEP OBJ ARR FIELD GET TRAVERSE AT
+// Never produced by the lexer: it starts the input when the driver asks for a bare path.
+%token PATH_START "path"
 
 %left '*'
 %nonassoc AT TRAVERSE FIELD GET
 
 %nterm <Expression> exp
 %nterm <Value> value
-%nterm <std::vector<Value>> valueList
-%nterm <std::string> fieldName
+%nterm <Array> valueList
+%nterm <FieldName> fieldName
 %nterm <Object::Field> field
-%nterm <std::vector<Object::Field>> fieldList
+%nterm <Object::Fields> fieldList
 %nterm <Path> path
-%nterm <std::vector<std::string>> stringList
+%nterm <std::vector<FieldName>> stringList
 
 %start start
 
 %%
 
-start: exp EOF       { driver->setAST(std::move($1)); }
-  | start error EOF  { yyerrok; }
+start: exp EOF             { driver->setAST(std::move($1)); }
+  | PATH_START path EOF    { driver->setPath(std::move($2)); }
+  | start error EOF        { yyerrok; }
 ;
 
 exp: value           { $$ = Expression::make<ConstantValue>(std::move($1), std::move(@$)); }
@@ -67,28 +107,30 @@ exp: value           { $$ = Expression::make<ConstantValue>(std::move($1), std::
 ;
 
 value: NOTHING       { $$ = Value::make<NothingValue>(); }
- | INTEGER           { $$ = Value::make<ScalarValue>(Scalar(atoi($1.c_str()))); }
- | FLOAT             { $$ = Value::make<ScalarValue>(Scalar(atof($1.c_str()))); }
- | STRING            { $$ = Value::make<ScalarValue>(Scalar(std::move($1))); }
+ | INTEGER           { $$ = Value::make<ScalarValue>(Scalar(toNumber<int32_t>($1, @1))); }
+ | FLOAT             { $$ = Value::make<ScalarValue>(Scalar(toNumber<double>($1, @1))); }
+ | STRING            { $$ = Value::make<ScalarValue>(Scalar(std::string{$1})); }
  | BOOLEAN           { $$ = Value::make<ScalarValue>(Scalar($1)); }
- | '[' ']'           { $$ = Value::make<ArrayValue>(std::vector<Value>{}); }
+ | '[' ']'           { $$ = Value::make<ArrayValue>(Array{}); }
  | '[' valueList ']' { $$ = Value::make<ArrayValue>(std::move($2)); }
  | '{' '}'           { $$ = Value::make<ObjectValue>(Object{}); }
  | '{' fieldList '}' { $$ = Value::make<ObjectValue>(Object{std::move($2)}); }
 ;
 
-valueList: value       { $$ = std::vector<Value>{std::move($1)}; }
+valueList: value       { $$.emplace_back(std::move($1)); }
  | valueList ',' value { $1.emplace_back(std::move($3));
                          $$ = std::move($1); }
 ;
 
-field: fieldName ':' value { $$ = Object::Field{$1, $3}; }
+field: fieldName ':' value { $$ = Object::Field{std::move($1), std::move($3)}; }
 ;
 
-fieldName : IDENTIFIER | STRING | INTEGER
+fieldName : IDENTIFIER { $$ = FieldName{$1}; }
+ | STRING              { $$ = FieldName{$1}; }
+ | INTEGER             { $$ = FieldName{$1}; }
 ;
 
-fieldList: field       { $$ = std::vector<Object::Field>{std::move($1)}; }
+fieldList: field       { $$.emplace_back(std::move($1)); }
  | fieldList ',' field { $1.emplace_back(std::move($3));
                          $$ = std::move($1); }
 ;
@@ -104,13 +146,13 @@ path: '(' path ')'          { $$ = std::move($2); }
  | ARR                      { $$ = Path::make<ArrPath>(); }
  | FIELD fieldName path     { $$ = Path::make<FieldPath>(std::move($2), std::move($3)); }
  | GET fieldName path       { $$ = Path::make<GetPath>(std::move($2), std::move($3)); }
- | AT INTEGER path %prec AT { $$ = Path::make<AtPath>(atoi($2.c_str()), std::move($3)); }
+ | AT INTEGER path %prec AT { $$ = Path::make<AtPath>(toNumber<int32_t>($2, @2), std::move($3)); }
  | TRAVERSE path            { $$ = Path::make<TraversePath>(std::move($2)); }
  | path '*' path            { $$ = Path::make<CompositionPath>(std::move($1), std::move($3)); }
 ;
 
-stringList: STRING       { $$ = std::vector<std::string>{std::move($1)}; }
- | stringList ',' STRING { $1.emplace_back(std::move($3));
+stringList: STRING       { $$.emplace_back($1); }
+ | stringList ',' STRING { $1.emplace_back($3);
                            $$ = std::move($1); }
 ;
 %%
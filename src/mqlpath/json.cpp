@@ -0,0 +1,722 @@
+#include "mqlpath/json.h"
+#include "mqlpath/numbers.h"
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace mqlpath {
+namespace {
+/**
+ * Nesting deeper than this is rejected instead of overflowing the stack.
+ */
+constexpr size_t kMaxDepth = 512;
+
+// Projection of a document of which nothing is needed: it is still parsed as a value.
+const FieldSet kShape = FieldSet::shape();
+
+/**
+ * Recursive descent parser over a single JSON text. Fields and elements of the containers being
+ * parsed are collected on stacks shared by all nesting levels, so every object and array is
+ * built with a vector allocated once at its final size.
+ */
+class JsonParser {
+public:
+    explicit JsonParser(std::string_view text)
+        : _begin(text.data()), _current(text.data()), _end(text.data() + text.size()) {}
+
+    /**
+     * Parses the document, building only the parts of it in 'projection'. The others are still
+     * checked to be valid JSON.
+     */
+    Value parseDocument(const FieldSet& projection) {
+        skipWhitespace();
+        auto value = parseValue(0, projection.isEmpty() ? kShape : projection);
+        skipWhitespace();
+        if (_current != _end) {
+            fail("unexpected characters after the value");
+        }
+        return value;
+    }
+
+    /**
+     * Restarts the parser on another text, keeping the capacity of its stacks.
+     */
+    void reset(std::string_view text) {
+        _begin = text.data();
+        _current = text.data();
+        _end = text.data() + text.size();
+    }
+
+private:
+    [[noreturn]] void fail(const char* message) const {
+        throw std::invalid_argument(std::string{"invalid JSON: "} + message + " at offset " +
+                                    std::to_string(_current - _begin));
+    }
+
+    void skipWhitespace() {
+        while (_current != _end &&
+               (*_current == ' ' || *_current == '\n' || *_current == '\r' || *_current == '\t')) {
+            ++_current;
+        }
+    }
+
+    void expect(char c) {
+        if (_current == _end || *_current != c) {
+            fail("unexpected character");
+        }
+        ++_current;
+    }
+
+    void expectLiteral(std::string_view literal) {
+        if (static_cast<size_t>(_end - _current) < literal.size() ||
+            std::memcmp(_current, literal.data(), literal.size()) != 0) {
+            fail("invalid literal");
+        }
+        _current += literal.size();
+    }
+
+    Value parseValue(size_t depth, const FieldSet& projection) {
+        if (_current == _end) {
+            fail("unexpected end of input");
+        }
+        switch (*_current) {
+            case '{':
+                return parseObject(depth + 1, projection);
+            case '[':
+                return parseArray(depth + 1, projection);
+            case '"':
+                return Value::make<ScalarValue>(Scalar{parseString()});
+            case 't':
+                expectLiteral("true");
+                return Value::make<ScalarValue>(Scalar{true});
+            case 'f':
+                expectLiteral("false");
+                return Value::make<ScalarValue>(Scalar{false});
+            case 'n':
+                expectLiteral("null");
+                return Value::make<NothingValue>();
+            default:
+                return parseNumber();
+        }
+    }
+
+    Value parseObject(size_t depth, const FieldSet& projection) {
+        if (depth > kMaxDepth) {
+            fail("nesting too deep");
+        }
+        ++_current;
+        const size_t first = _fields.size();
+        skipWhitespace();
+        if (_current != _end && *_current == '}') {
+            ++_current;
+            return Value::make<ObjectValue>(Object{});
+        }
+
+        while (true) {
+            skipWhitespace();
+            if (_current == _end || *_current != '"') {
+                fail("expected a field name");
+            }
+            auto name = _names.get(parseString());
+            skipWhitespace();
+            expect(':');
+            skipWhitespace();
+            const auto& fieldProjection = projection.getField(name);
+            if (fieldProjection.isEmpty()) {
+                skipValue(depth);
+            } else if (auto value = parseValue(depth, fieldProjection); !isNothing(value)) {
+                _fields.emplace_back(std::move(name), std::move(value));
+            }
+            skipWhitespace();
+            if (_current != _end && *_current == ',') {
+                ++_current;
+                continue;
+            }
+            expect('}');
+            break;
+        }
+
+        Object::Fields fields{};
+        fields.reserve(_fields.size() - first);
+        fields.insert(fields.end(),
+                      std::make_move_iterator(_fields.begin() + first),
+                      std::make_move_iterator(_fields.end()));
+        _fields.resize(first);
+        return Value::make<ObjectValue>(Object{std::move(fields)});
+    }
+
+    Value parseArray(size_t depth, const FieldSet& projection) {
+        const auto& elementProjection = projection.getElements();
+        if (elementProjection.isEmpty()) {
+            skipArray(depth);
+            return Value::make<ArrayValue>(Array{});
+        }
+        if (depth > kMaxDepth) {
+            fail("nesting too deep");
+        }
+        ++_current;
+        const size_t first = _elements.size();
+        skipWhitespace();
+        if (_current != _end && *_current == ']') {
+            ++_current;
+            return Value::make<ArrayValue>(Array{});
+        }
+
+        while (true) {
+            skipWhitespace();
+            _elements.emplace_back(parseValue(depth, elementProjection));
+            skipWhitespace();
+            if (_current != _end && *_current == ',') {
+                ++_current;
+                continue;
+            }
+            expect(']');
+            break;
+        }
+
+        Array elements{};
+        elements.reserve(_elements.size() - first);
+        elements.insert(elements.end(),
+                        std::make_move_iterator(_elements.begin() + first),
+                        std::make_move_iterator(_elements.end()));
+        _elements.resize(first);
+        return Value::make<ArrayValue>(std::move(elements));
+    }
+
+    /**
+     * Moves past a value which is left out of the document, checking it as parseValue() would
+     * without building it.
+     */
+    void skipValue(size_t depth) {
+        if (_current == _end) {
+            fail("unexpected end of input");
+        }
+        switch (*_current) {
+            case '{':
+                skipObject(depth + 1);
+                return;
+            case '[':
+                skipArray(depth + 1);
+                return;
+            case '"':
+                skipString();
+                return;
+            case 't':
+                expectLiteral("true");
+                return;
+            case 'f':
+                expectLiteral("false");
+                return;
+            case 'n':
+                expectLiteral("null");
+                return;
+            default:
+                parseNumber();
+                return;
+        }
+    }
+
+    void skipObject(size_t depth) {
+        if (depth > kMaxDepth) {
+            fail("nesting too deep");
+        }
+        ++_current;
+        skipWhitespace();
+        if (_current != _end && *_current == '}') {
+            ++_current;
+            return;
+        }
+
+        while (true) {
+            skipWhitespace();
+            if (_current == _end || *_current != '"') {
+                fail("expected a field name");
+            }
+            skipString();
+            skipWhitespace();
+            expect(':');
+            skipWhitespace();
+            skipValue(depth);
+            skipWhitespace();
+            if (_current != _end && *_current == ',') {
+                ++_current;
+                continue;
+            }
+            expect('}');
+            return;
+        }
+    }
+
+    void skipArray(size_t depth) {
+        if (depth > kMaxDepth) {
+            fail("nesting too deep");
+        }
+        ++_current;
+        skipWhitespace();
+        if (_current != _end && *_current == ']') {
+            ++_current;
+            return;
+        }
+
+        while (true) {
+            skipWhitespace();
+            skipValue(depth);
+            skipWhitespace();
+            if (_current != _end && *_current == ',') {
+                ++_current;
+                continue;
+            }
+            expect(']');
+            return;
+        }
+    }
+
+    void skipString() {
+        ++_current;
+        while (true) {
+            skipValidCharacters();
+            if (_current == _end) {
+                fail("unterminated string");
+            }
+            const char c = *_current;
+            if (c == '"') {
+                ++_current;
+                return;
+            }
+            if (c != '\\') {
+                fail("control character in string");
+            }
+            ++_current;
+            // Escapes are checked by decoding them into a buffer which is then dropped.
+            _escape.clear();
+            appendEscape(_escape);
+        }
+    }
+
+    /**
+     * Advances to the next byte of a string which needs attention: a quote, a backslash, a
+     * control character or the start of a multi-byte UTF-8 sequence. Plain ASCII is skipped 16
+     * bytes at a time where SSE2 is available.
+     */
+    void skipPlainCharacters() {
+#if defined(__SSE2__)
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        // Control characters are below 0x20; non-ASCII bytes are negative as signed chars.
+        const __m128i space = _mm_set1_epi8(0x20);
+        while (_end - _current >= 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_current));
+            const __m128i special =
+                _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                          _mm_cmpeq_epi8(chunk, backslash)),
+                             _mm_cmplt_epi8(chunk, space));
+            const int mask = _mm_movemask_epi8(special);
+            if (mask != 0) {
+                _current += std::countr_zero(static_cast<unsigned>(mask));
+                return;
+            }
+            _current += 16;
+        }
+#endif
+        while (_current != _end) {
+            const auto c = static_cast<unsigned char>(*_current);
+            if (c == '"' || c == '\\' || c < 0x20 || c >= 0x80) {
+                return;
+            }
+            ++_current;
+        }
+    }
+
+    /**
+     * Checks the UTF-8 sequence starting at the current position and moves past it.
+     */
+    void skipUtf8Sequence() {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(_current);
+        const size_t available = _end - _current;
+        const unsigned char lead = bytes[0];
+        size_t length;
+        uint32_t codePoint;
+        if (lead >= 0xC2 && lead <= 0xDF) {
+            length = 2;
+            codePoint = lead & 0x1F;
+        } else if (lead >= 0xE0 && lead <= 0xEF) {
+            length = 3;
+            codePoint = lead & 0x0F;
+        } else if (lead >= 0xF0 && lead <= 0xF4) {
+            length = 4;
+            codePoint = lead & 0x07;
+        } else {
+            fail("invalid UTF-8");
+        }
+        if (available < length) {
+            fail("invalid UTF-8");
+        }
+        for (size_t i = 1; i < length; ++i) {
+            if ((bytes[i] & 0xC0) != 0x80) {
+                fail("invalid UTF-8");
+            }
+            codePoint = (codePoint << 6) | (bytes[i] & 0x3F);
+        }
+        // Reject overlong encodings, surrogates and code points above U+10FFFF.
+        if ((length == 3 && codePoint < 0x800) || (length == 4 && codePoint < 0x10000) ||
+            (codePoint >= 0xD800 && codePoint <= 0xDFFF) || codePoint > 0x10FFFF) {
+            fail("invalid UTF-8");
+        }
+        _current += length;
+    }
+
+    std::string parseString() {
+        ++_current;
+        const char* start = _current;
+        skipValidCharacters();
+        if (_current != _end && *_current == '"') {
+            // The common case: no escape sequences, the string is copied once.
+            std::string result{start, _current};
+            ++_current;
+            return result;
+        }
+
+        std::string result{start, _current};
+        while (true) {
+            if (_current == _end) {
+                fail("unterminated string");
+            }
+            const char c = *_current;
+            if (c == '"') {
+                ++_current;
+                return result;
+            }
+            if (c != '\\') {
+                fail("control character in string");
+            }
+            ++_current;
+            appendEscape(result);
+            start = _current;
+            skipValidCharacters();
+            result.append(start, _current);
+        }
+    }
+
+    /**
+     * Skips the characters of a string up to a quote, a backslash, a control character or the
+     * end of input, validating UTF-8 sequences on the way.
+     */
+    void skipValidCharacters() {
+        while (true) {
+            skipPlainCharacters();
+            if (_current == _end || static_cast<unsigned char>(*_current) < 0x80) {
+                return;
+            }
+            skipUtf8Sequence();
+        }
+    }
+
+    void appendEscape(std::string& result) {
+        if (_current == _end) {
+            fail("unterminated string");
+        }
+        switch (*_current++) {
+            case '"':
+                result.push_back('"');
+                return;
+            case '\\':
+                result.push_back('\\');
+                return;
+            case '/':
+                result.push_back('/');
+                return;
+            case 'b':
+                result.push_back('\b');
+                return;
+            case 'f':
+                result.push_back('\f');
+                return;
+            case 'n':
+                result.push_back('\n');
+                return;
+            case 'r':
+                result.push_back('\r');
+                return;
+            case 't':
+                result.push_back('\t');
+                return;
+            case 'u':
+                appendCodePoint(result, parseUnicodeEscape());
+                return;
+            default:
+                --_current;
+                fail("invalid escape sequence");
+        }
+    }
+
+    uint32_t parseHex4() {
+        uint32_t result = 0;
+        if (_end - _current < 4 ||
+            std::from_chars(_current, _current + 4, result, 16).ptr != _current + 4) {
+            fail("invalid unicode escape");
+        }
+        _current += 4;
+        return result;
+    }
+
+    uint32_t parseUnicodeEscape() {
+        const uint32_t first = parseHex4();
+        if (first < 0xD800 || first > 0xDFFF) {
+            return first;
+        }
+        if (first > 0xDBFF || _end - _current < 2 || _current[0] != '\\' || _current[1] != 'u') {
+            fail("unpaired surrogate");
+        }
+        _current += 2;
+        const uint32_t second = parseHex4();
+        if (second < 0xDC00 || second > 0xDFFF) {
+            fail("unpaired surrogate");
+        }
+        return 0x10000 + ((first - 0xD800) << 10) + (second - 0xDC00);
+    }
+
+    static void appendCodePoint(std::string& result, uint32_t codePoint) {
+        if (codePoint < 0x80) {
+            result.push_back(static_cast<char>(codePoint));
+        } else if (codePoint < 0x800) {
+            result.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+            result.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        } else if (codePoint < 0x10000) {
+            result.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+            result.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+            result.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        } else {
+            result.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+            result.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+            result.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+            result.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+    }
+
+    void skipDigits() {
+        while (_current != _end && *_current >= '0' && *_current <= '9') {
+            ++_current;
+        }
+    }
+
+    Value parseNumber() {
+        // Check the JSON number grammar first: from_chars alone would accept e.g. "01" or "1.".
+        const char* start = _current;
+        if (_current != _end && *_current == '-') {
+            ++_current;
+        }
+        if (_current == _end || *_current < '0' || *_current > '9') {
+            fail("unexpected character");
+        }
+        if (*_current == '0') {
+            ++_current;
+        } else {
+            skipDigits();
+        }
+
+        bool integral = true;
+        if (_current != _end && *_current == '.') {
+            integral = false;
+            ++_current;
+            const char* digits = _current;
+            skipDigits();
+            if (_current == digits) {
+                fail("invalid number");
+            }
+        }
+        if (_current != _end && (*_current == 'e' || *_current == 'E')) {
+            integral = false;
+            ++_current;
+            if (_current != _end && (*_current == '+' || *_current == '-')) {
+                ++_current;
+            }
+            const char* digits = _current;
+            skipDigits();
+            if (_current == digits) {
+                fail("invalid number");
+            }
+        }
+
+        // -0 is a double, as an int32 would lose its sign.
+        if (integral && !(*start == '-' && start[1] == '0')) {
+            int32_t result;
+            auto [end, error] = std::from_chars(start, _current, result);
+            if (error == std::errc{}) {
+                return Value::make<ScalarValue>(Scalar{result});
+            }
+            // Integers outside of int32 fall back to double.
+        }
+        double result;
+        auto [end, error] = parseDouble(start, _current, result);
+        if (error == std::errc::result_out_of_range) {
+            _current = start;
+            fail("number out of range");
+        }
+        return Value::make<ScalarValue>(Scalar{result});
+    }
+
+    const char* _begin;
+    const char* _current;
+    const char* _end;
+    std::vector<Object::Field> _fields;
+    std::vector<Value> _elements;
+    std::string _escape;
+    // Shared by the documents of an NDJSON text, which mostly repeat their keys.
+    FieldNameCache _names;
+};
+
+/**
+ * Appends the JSON text of a value to a string. Doubles are written in their shortest form which
+ * reads back to the same double, with ".0" added to integral ones so that they stay doubles.
+ */
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string& text) : _text(text) {}
+
+    void operator()(const Value&, const NothingValue&) {
+        _text.append("null");
+    }
+
+    void operator()(const Value&, const ScalarValue& scalar) {
+        if (auto boolValue = std::get_if<bool>(&scalar.scalar); boolValue != nullptr) {
+            _text.append(*boolValue ? "true" : "false");
+        } else if (auto int32Value = std::get_if<int32_t>(&scalar.scalar); int32Value != nullptr) {
+            char digits[16];
+            _text.append(digits, std::to_chars(digits, digits + sizeof(digits), *int32Value).ptr);
+        } else if (auto doubleValue = std::get_if<double>(&scalar.scalar); doubleValue != nullptr) {
+            writeDouble(*doubleValue);
+        } else {
+            writeString(std::get<std::string>(scalar.scalar));
+        }
+    }
+
+    void operator()(const Value&, const ArrayValue& array) {
+        _text.push_back('[');
+        for (size_t index = 0; index < array.array.size(); ++index) {
+            if (index != 0) {
+                _text.push_back(',');
+            }
+            array.array[index].visit(*this);
+        }
+        _text.push_back(']');
+    }
+
+    void operator()(const Value&, const ObjectValue& objectValue) {
+        const auto& names = objectValue.object.getNames();
+        const auto& values = objectValue.object.getValues();
+        _text.push_back('{');
+        bool first = true;
+        for (size_t position = 0; position < names.size(); ++position) {
+            if (isNothing(values[position])) {
+                continue;
+            }
+            if (!first) {
+                _text.push_back(',');
+            }
+            first = false;
+            writeString(names[position].str());
+            _text.push_back(':');
+            values[position].visit(*this);
+        }
+        _text.push_back('}');
+    }
+
+private:
+    void writeDouble(double value) {
+        if (!std::isfinite(value)) {
+            _text.append("null");
+            return;
+        }
+        char digits[32];
+        const auto end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+        _text.append(digits, end);
+        if (std::find_if(digits, end, [](char c) { return c == '.' || c == 'e'; }) == end) {
+            _text.append(".0");
+        }
+    }
+
+    void writeString(std::string_view string) {
+        static constexpr char kHexDigits[] = "0123456789abcdef";
+        _text.push_back('"');
+        size_t plainStart = 0;
+        for (size_t position = 0; position < string.size(); ++position) {
+            const auto byte = static_cast<unsigned char>(string[position]);
+            if (byte >= 0x20 && byte != '"' && byte != '\\') {
+                continue;
+            }
+            _text.append(string.substr(plainStart, position - plainStart));
+            plainStart = position + 1;
+            switch (byte) {
+                case '"':
+                    _text.append("\\\"");
+                    break;
+                case '\\':
+                    _text.append("\\\\");
+                    break;
+                case '\n':
+                    _text.append("\\n");
+                    break;
+                case '\r':
+                    _text.append("\\r");
+                    break;
+                case '\t':
+                    _text.append("\\t");
+                    break;
+                default:
+                    _text.append("\\u00");
+                    _text.push_back(kHexDigits[byte >> 4]);
+                    _text.push_back(kHexDigits[byte & 0xF]);
+                    break;
+            }
+        }
+        _text.append(string.substr(plainStart));
+        _text.push_back('"');
+    }
+
+    std::string& _text;
+};
+}  // namespace
+
+Value parseJson(std::string_view text, const FieldSet& projection) {
+    JsonParser parser{text};
+    return parser.parseDocument(projection);
+}
+
+void parseNdjson(std::string_view text,
+                 std::vector<Value>& documents,
+                 size_t firstLine,
+                 const FieldSet& projection) {
+    JsonParser parser{{}};
+    size_t lineNumber = firstLine - 1;
+    while (!text.empty()) {
+        ++lineNumber;
+        const size_t lineEnd = text.find('\n');
+        auto line = text.substr(0, lineEnd);
+        text = lineEnd == std::string_view::npos ? std::string_view{} : text.substr(lineEnd + 1);
+
+        if (line.find_first_not_of(" \t\r") == std::string_view::npos) {
+            continue;
+        }
+        parser.reset(line);
+        try {
+            documents.emplace_back(parser.parseDocument(projection));
+        } catch (const std::invalid_argument& error) {
+            throw std::invalid_argument("line " + std::to_string(lineNumber) + ": " + error.what());
+        }
+    }
+}
+
+void appendJson(const Value& value, std::string& text) {
+    JsonWriter writer{text};
+    value.visit(writer);
+}
+}  // namespace mqlpath
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "mqlpath/field_set.h"
+#include "mqlpath/value.h"
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mqlpath {
+/**
+ * Parses a JSON text into a Value. Objects and arrays map to the corresponding Values, numbers
+ * without fraction or exponent which fit into int32 to int32 and all other numbers to double.
+ * null is Nothing, so an object field set to null is left out. Strings must be valid UTF-8.
+ * Throws std::invalid_argument with the offset of the first error.
+ *
+ * Only the parts of the document in 'projection' are built, see FieldSet::project(); the fields
+ * and elements it leaves out are skipped over, though still checked to be valid. An empty
+ * projection yields the document's shape().
+ */
+Value parseJson(std::string_view text, const FieldSet& projection = FieldSet::all());
+
+/**
+ * Parses newline-delimited JSON, one document per line, appending the documents to 'documents'.
+ * Blank lines are skipped. Errors are reported with the line number, counting the first line of
+ * 'text' as 'firstLine' so that a caller parsing a stream piecewise can report its position.
+ * Every document is projected as by parseJson().
+ */
+void parseNdjson(std::string_view text,
+                 std::vector<Value>& documents,
+                 size_t firstLine = 1,
+                 const FieldSet& projection = FieldSet::all());
+
+/**
+ * Appends the JSON text of the value to 'text'. Nothing and doubles which are not finite are
+ * written as null, except that Nothing fields of objects are left out. Strings are escaped but
+ * not checked to be valid UTF-8.
+ */
+void appendJson(const Value& value, std::string& text);
+}  // namespace mqlpath
@@ -0,0 +1,52 @@
+#include "mqlpath/ast_make.h"
+#include "mqlpath/json.h"
+#include "mqlpath/path_dependencies.h"
+#include "mqlpath/value.h"
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <lexer.h>
+#include <parser.h>
+#include <string>
+
+namespace mqlpath {
+TEST_CASE("NDJSON reader vs expression grammar", "[json][benchmark]") {
+    // Documents the grammar accepts as value literals too: no null and no escapes.
+    std::vector<std::string> documents{};
+    std::string ndjson{};
+    for (int i = 0; i < 1000; ++i) {
+        auto id = std::to_string(i);
+        auto document = R"({"id": )" + id + R"(, "name": "document number )" + id +
+            R"(", "score": )" + std::to_string(i * 0.25) + R"(, "active": )" +
+            (i % 2 == 0 ? "true" : "false") + R"(, "tags": ["alpha", "beta", "gamma"], )" +
+            R"("address": {"street": "Main Street )" + id + R"(", "zip": 12345}})";
+        ndjson += document;
+        ndjson += '\n';
+        documents.emplace_back(std::move(document));
+    }
+
+    // 1000 documents per run: divide the bytes by the time for the throughput.
+    BENCHMARK("parseNdjson 1000 documents, " + std::to_string(ndjson.size()) + " bytes") {
+        std::vector<Value> values{};
+        parseNdjson(ndjson, values);
+        return values.size();
+    };
+
+    auto projection = getReadSet(ast::get("address", ast::get("zip", ast::id())));
+    BENCHMARK("parseNdjson 1000 documents projected to address.zip") {
+        std::vector<Value> values{};
+        parseNdjson(ndjson, values, 1, projection);
+        return values.size();
+    };
+
+    BENCHMARK("grammar 1000 documents") {
+        size_t count = 0;
+        for (const auto& document : documents) {
+            Lexer lexer(document);
+            Driver driver{};
+            Parser parser{lexer, &driver};
+            count += parser.parse() == 0;
+        }
+        return count;
+    };
+}
+}  // namespace mqlpath
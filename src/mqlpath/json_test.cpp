@@ -0,0 +1,151 @@
+#include "mqlpath/ast_make.h"
+#include "mqlpath/json.h"
+#include "mqlpath/path_dependencies.h"
+#include "mqlpath/random_generator.h"
+#include <catch2/catch_message.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace mqlpath {
+TEST_CASE("JSON values map to Values", "[json]") {
+    REQUIRE(ast::value(1) == parseJson("1"));
+    REQUIRE(ast::value(-2147483647 - 1) == parseJson("-2147483648"));
+    REQUIRE(ast::value(2147483648.0) == parseJson("2147483648"));
+    REQUIRE(ast::value(1.5) == parseJson(" 1.5 "));
+    REQUIRE(ast::value(-1e10) == parseJson("-1E+10"));
+    // Numbers too small for a double round to zero, or to a denormal, as with strtod.
+    REQUIRE(ast::value(0.0) == parseJson("1e-400"));
+    REQUIRE(ast::value(0.0) == parseJson("0." + std::string(400, '0') + "1"));
+    REQUIRE(ast::value(5e-324) == parseJson("4.9e-324"));
+    auto negativeZero = parseJson("-0");
+    REQUIRE(std::signbit(std::get<double>(negativeZero.cast<ScalarValue>()->scalar)));
+    REQUIRE(std::signbit(std::get<double>(parseJson("-1e-400").cast<ScalarValue>()->scalar)));
+    REQUIRE(ast::value(true) == parseJson("true"));
+    REQUIRE(ast::value(false) == parseJson("false"));
+    REQUIRE(ast::nothing() == parseJson("null"));
+    REQUIRE(ast::value("text") == parseJson(R"("text")"));
+    REQUIRE(ast::value(std::vector<int32_t>{}) == parseJson("[ ]"));
+    REQUIRE(ast::value(Object{}) == parseJson("{ }"));
+
+    auto expected = ast::value(Object{{
+        {"a", ast::value(std::vector<int32_t>{1, 2})},
+        {"b", ast::value(Object{{{"c", ast::value("d")}}})},
+        {"e", Value::make<ArrayValue>(std::vector<Value>{ast::nothing(), ast::value(0.25)})},
+    }});
+    REQUIRE(expected ==
+            parseJson(R"( {"a": [1, 2], "b": {"c": "d"}, "n": null, "e": [null, 0.25]} )"));
+}
+
+TEST_CASE("JSON strings are unescaped and validated", "[json]") {
+    REQUIRE(ast::value("a\"b\\c/d\b\f\n\r\t") == parseJson(R"("a\"b\\c\/d\b\f\n\r\t")"));
+    REQUIRE(ast::value("\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80") ==
+            parseJson(R"("é€😀")"));
+    // Long enough to take the 16 byte scanning path, with multi-byte sequences inside.
+    const std::string text = "0123456789abcdef\xC3\xA9 0123456789abcdef \xE2\x82\xAC 0123456789";
+    REQUIRE(ast::value(text) == parseJson("\"" + text + "\""));
+
+    REQUIRE_THROWS_AS(parseJson("\"\xC3\""), std::invalid_argument);
+    REQUIRE_THROWS_AS(parseJson("\"\xC0\xAF\""), std::invalid_argument);
+    REQUIRE_THROWS_AS(parseJson("\"\xED\xA0\x80\""), std::invalid_argument);
+    REQUIRE_THROWS_AS(parseJson("\"0123456789abcdef\xFF\""), std::invalid_argument);
+    REQUIRE_THROWS_AS(parseJson("\"a\nb\""), std::invalid_argument);
+    REQUIRE_THROWS_AS(parseJson(R"("\ud83d")"), std::invalid_argument);
+    REQUIRE_THROWS_AS(parseJson(R"("\x")"), std::invalid_argument);
+    REQUIRE_THROWS_AS(parseJson(R"("abc)"), std::invalid_argument);
+}
+
+TEST_CASE("malformed JSON is rejected", "[json]") {
+    for (const char* text : {"", "01", "1.", "-", "1e", "+1", "[1,]", "{\"a\":1,}", "{a:1}",
+                             "[1 2]", "tru", "nul", "1 2", "{\"a\" 1}", "1e400"}) {
+        INFO(text);
+        REQUIRE_THROWS_AS(parseJson(text), std::invalid_argument);
+    }
+    REQUIRE_THROWS_AS(parseJson(std::string(1000, '[') + std::string(1000, ']')),
+                      std::invalid_argument);
+}
+
+TEST_CASE("NDJSON yields one document per line", "[json]") {
+    std::vector<Value> documents{};
+    parseNdjson("{\"a\": 1}\n\n  \r\n[2]\r\n3", documents);
+    REQUIRE(documents.size() == 3);
+    REQUIRE(ast::value(Object{{{"a", ast::value(1)}}}) == documents[0]);
+    REQUIRE(ast::value(std::vector<int32_t>{2}) == documents[1]);
+    REQUIRE(ast::value(3) == documents[2]);
+
+    try {
+        parseNdjson("1\n2\n{\"a\": }\n", documents);
+        FAIL("expected an error");
+    } catch (const std::invalid_argument& error) {
+        REQUIRE(std::string{error.what()}.starts_with("line 3: "));
+    }
+}
+
+TEST_CASE("JSON writer output reads back to the same value", "[json]") {
+    Object::Fields fields{
+        {"int", ast::value(-3)},
+        {"double", ast::value(2.0)},
+        {"fraction", ast::value(0.1)},
+        {"string", ast::value("q\"b\\n\n\x01\xC3\xA9")},
+        {"array", Value::make<ArrayValue>(std::vector<Value>{ast::nothing(), ast::value(true)})},
+        {"object", ast::value(Object{})},
+    };
+    auto expected = ast::value(Object{fields});
+    fields.emplace_back("skipped", ast::nothing());
+
+    std::string text{};
+    appendJson(ast::value(Object{fields}), text);
+    REQUIRE(text ==
+            R"({"int":-3,"double":2.0,"fraction":0.1,"string":"q\"b\\n\n\u0001)"
+            "\xC3\xA9"
+            R"(","array":[null,true],"object":{}})");
+    REQUIRE(expected == parseJson(text));
+}
+
+TEST_CASE("JSON reader builds the projected parts alone", "[json]") {
+    const std::string text = R"({"a": {"b": [1, {"c": "\u0041"}], "d": 2}, "e": [{"f": 3}, 4]})";
+    auto projection = FieldSet::shape();
+    auto a = FieldSet::shape();
+    a.setField("b", FieldSet::all());
+    projection.setField("a", a);
+    projection.setField("e", FieldSet::shape());
+    REQUIRE(ast::value(Object{{
+                {"a", ast::value(Object{{{"b", parseJson(R"([1, {"c": "A"}])")}}})},
+                {"e", ast::value(std::vector<int32_t>{})},
+            }}) == parseJson(text, projection));
+    REQUIRE(ast::value(Object{}) == parseJson(text, FieldSet{}));
+
+    // Skipped values are still checked.
+    for (const char* skipped : {R"({"a": 1, "x": [1,]})", R"({"a": 1, "x": "\q"})",
+                                R"({"a": 1, "x": {"y" 1}})", R"({"a": 1, "x": 01})"}) {
+        INFO(skipped);
+        REQUIRE_THROWS_AS(parseJson(skipped, projection), std::invalid_argument);
+    }
+
+    std::vector<Value> documents{};
+    parseNdjson("{\"a\": 1, \"b\": 2}\n{\"b\": 3}", documents, 1, getReadSet(ast::keep({"b"})));
+    REQUIRE(documents.size() == 2);
+    REQUIRE(ast::value(Object{{{"b", ast::value(2)}}}) == documents[0]);
+    REQUIRE(ast::value(Object{{{"b", ast::value(3)}}}) == documents[1]);
+}
+
+TEST_CASE("JSON reader projects as the read sets of paths", "[json]") {
+    RandomGenerator generator{20241017};
+    std::string text{};
+    for (int i = 0; i < 2000; ++i) {
+        auto projection = getReadSet(generator.path(4));
+        INFO(projection);
+        for (int j = 0; j < 5; ++j) {
+            auto document = generator.value(3);
+            INFO(document);
+            text.clear();
+            appendJson(document, text);
+            // The readers build the shape of a document which is not read at all.
+            const auto& built = projection.isEmpty() ? FieldSet::shape() : projection;
+            auto expected = built.project(document);
+            REQUIRE(expected == parseJson(text, projection));
+        }
+    }
+}
+}  // namespace mqlpath
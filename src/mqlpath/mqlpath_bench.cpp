@@ -0,0 +1,400 @@
+#include "mqlpath/ast_eval.h"
+#include "mqlpath/ast_make.h"
+#include "mqlpath/corpus_generator.h"
+#include "mqlpath/json.h"
+#include "mqlpath/prepared_path.h"
+#include "mqlpath/value.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <lexer.h>
+#include <parser.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mqlpath {
+namespace {
+constexpr std::string_view kUsage = R"(Usage: mqlpath-bench [options]
+
+Runs the benchmark suite over a generated corpus and writes the results as JSON.
+
+Corpus options:
+  --documents <n>         documents in the corpus (default 1000)
+  --width <n>             fields of every object (default 10)
+  --depth <n>             levels of objects and arrays below the documents (default 2)
+  --array-length <n>      elements of every array (default 4)
+  --scalar-mix <i,d,s,b>  weights of int32, double, string and bool scalars (default 4,2,3,1)
+  --nesting-mix <o,a>     weights of nested objects and arrays against scalars (default 1,1)
+  --seed <n>              seed of the corpus (default 42)
+
+Run options:
+  --samples <n>           samples per benchmark (default 10)
+  --sample-ms <n>         minimum duration of a sample in milliseconds (default 10)
+  --filter <text>         runs only the benchmarks whose name contains the text
+  --output <file>         writes the JSON to the file instead of stdout
+)";
+
+struct SuiteOptions {
+    CorpusOptions corpus{};
+    size_t documents{1000};
+    size_t samples{10};
+    size_t sampleMilliseconds{10};
+    std::string filter{};
+    std::string output{};
+};
+
+/**
+ * A benchmark runs over the whole corpus once per iteration and returns a value derived from its
+ * results, which keeps the compiler from dropping the work.
+ */
+struct Benchmark {
+    std::string group;
+    std::string name;
+    std::function<size_t()> run;
+    // Items and bytes processed per iteration, for the throughput. Zero when not meaningful.
+    size_t items{0};
+    size_t bytes{0};
+};
+
+struct Statistics {
+    size_t iterations{0};
+    std::vector<double> samples{};
+    double mean{0};
+    double median{0};
+    double min{0};
+    double stddev{0};
+};
+
+volatile size_t sink = 0;
+
+/**
+ * Picks the number of iterations which makes one sample last at least 'sampleMilliseconds', then
+ * times 'samples' samples. All durations are nanoseconds per iteration.
+ */
+Statistics measure(const Benchmark& benchmark, const SuiteOptions& options) {
+    using Clock = std::chrono::steady_clock;
+    const auto timeIterations = [&](size_t iterations) {
+        const auto start = Clock::now();
+        size_t result = 0;
+        for (size_t i = 0; i < iterations; ++i) {
+            result += benchmark.run();
+        }
+        const auto elapsed = Clock::now() - start;
+        sink = sink + result;
+        return std::chrono::duration<double, std::nano>(elapsed).count();
+    };
+
+    Statistics statistics{};
+    const double minimum = static_cast<double>(options.sampleMilliseconds) * 1e6;
+    statistics.iterations = 1;
+    while (timeIterations(statistics.iterations) < minimum) {
+        statistics.iterations *= 2;
+    }
+
+    for (size_t sample = 0; sample < options.samples; ++sample) {
+        statistics.samples.push_back(timeIterations(statistics.iterations) /
+                                     static_cast<double>(statistics.iterations));
+    }
+    auto sorted = statistics.samples;
+    std::sort(sorted.begin(), sorted.end());
+    statistics.min = sorted.front();
+    statistics.median = sorted.size() % 2 == 1
+        ? sorted[sorted.size() / 2]
+        : (sorted[sorted.size() / 2 - 1] + sorted[sorted.size() / 2]) / 2;
+    for (auto sample : sorted) {
+        statistics.mean += sample;
+    }
+    statistics.mean /= static_cast<double>(sorted.size());
+    for (auto sample : sorted) {
+        statistics.stddev += (sample - statistics.mean) * (sample - statistics.mean);
+    }
+    statistics.stddev = std::sqrt(statistics.stddev / static_cast<double>(sorted.size()));
+    return statistics;
+}
+
+/**
+ * Paths covering every Path kind over the fields which the corpus generator guarantees.
+ */
+std::vector<Path> makePaths() {
+    return {
+        ast::id(),
+        ast::constPath(1),
+        ast::defaultPath(0),
+        ast::lambda(1),
+        ast::drop({"f2"}),
+        ast::keep({"f0", "f2"}),
+        ast::obj(),
+        ast::arr(),
+        ast::field("f2", ast::constPath(1)),
+        ast::get("f0", ast::get("f2", ast::id())),
+        ast::get("f1", ast::at(0, ast::id())),
+        ast::get("f1", ast::traverse(ast::obj())),
+        ast::compose(ast::drop({"f2"}), ast::get("f0", ast::id())),
+    };
+}
+
+std::vector<Benchmark> makeBenchmarks(const std::vector<Value>& documents,
+                                      const std::vector<std::string>& sources,
+                                      size_t sourceBytes) {
+    std::vector<Benchmark> benchmarks{};
+    const size_t count = documents.size();
+
+    benchmarks.push_back({"lexer", "lex documents", [&sources] {
+                              size_t tokens = 0;
+                              Driver driver{};
+                              for (const auto& source : sources) {
+                                  Lexer lexer(source);
+                                  while (lexer.lex(&driver).kind() !=
+                                         Parser::symbol_kind::S_YYEOF) {
+                                      ++tokens;
+                                  }
+                              }
+                              return tokens;
+                          },
+                          count, sourceBytes});
+
+    benchmarks.push_back({"parser", "parse documents", [&sources] {
+                              size_t parsed = 0;
+                              for (const auto& source : sources) {
+                                  Lexer lexer(source);
+                                  Driver driver{};
+                                  Parser parser{lexer, &driver};
+                                  parsed += parser.parse() == 0;
+                              }
+                              return parsed;
+                          },
+                          count, sourceBytes});
+
+    for (const auto& path : makePaths()) {
+        std::ostringstream name{};
+        name << path;
+        benchmarks.push_back({"evaluate", name.str(), [&documents, path] {
+                                  size_t results = 0;
+                                  for (const auto& document : documents) {
+                                      results += !isNothing(evaluate(path, document));
+                                  }
+                                  return results;
+                              },
+                              count});
+
+        auto prepared = std::make_shared<PreparedPath>(path);
+        benchmarks.push_back({"prepared", name.str(), [&documents, prepared] {
+                                  size_t results = 0;
+                                  for (const auto& document : documents) {
+                                      results += !isNothing(prepared->evaluate(document));
+                                  }
+                                  return results;
+                              },
+                              count});
+    }
+
+    benchmarks.push_back({"value", "copy", [&documents] {
+                              size_t copies = 0;
+                              for (const auto& document : documents) {
+                                  Value copy{document};
+                                  copies += isObject(copy);
+                              }
+                              return copies;
+                          },
+                          count});
+
+    benchmarks.push_back({"value", "copy and mutate", [&documents] {
+                              size_t copies = 0;
+                              for (const auto& document : documents) {
+                                  Value copy{document};
+                                  copy.cast<ObjectValue>()->object.dropFields({"f0"});
+                                  copies += isObject(copy);
+                              }
+                              return copies;
+                          },
+                          count});
+
+    benchmarks.push_back({"value", "print", [&documents] {
+                              std::ostringstream output{};
+                              for (const auto& document : documents) {
+                                  output << document << '\n';
+                              }
+                              return output.str().size();
+                          },
+                          count});
+    return benchmarks;
+}
+
+Value toValue(const CorpusOptions& options, size_t documents, size_t sourceBytes) {
+    Object object{};
+    object.setValue("documents", ast::value(static_cast<int32_t>(documents)));
+    object.setValue("sourceBytes", ast::value(static_cast<double>(sourceBytes)));
+    object.setValue("width", ast::value(static_cast<int32_t>(options.width)));
+    object.setValue("depth", ast::value(static_cast<int32_t>(options.depth)));
+    object.setValue("arrayLength", ast::value(static_cast<int32_t>(options.arrayLength)));
+    object.setValue("scalarMix",
+                    ast::value(std::vector<int32_t>{static_cast<int32_t>(options.int32Weight),
+                                                    static_cast<int32_t>(options.doubleWeight),
+                                                    static_cast<int32_t>(options.stringWeight),
+                                                    static_cast<int32_t>(options.boolWeight)}));
+    object.setValue("nestingMix",
+                    ast::value(std::vector<int32_t>{static_cast<int32_t>(options.objectWeight),
+                                                    static_cast<int32_t>(options.arrayWeight)}));
+    object.setValue("seed", ast::value(static_cast<double>(options.seed)));
+    return ast::value(std::move(object));
+}
+
+Value toValue(const Benchmark& benchmark, const Statistics& statistics) {
+    Object object{};
+    object.setValue("group", ast::value(benchmark.group));
+    object.setValue("name", ast::value(benchmark.name));
+    object.setValue("iterations", ast::value(static_cast<int32_t>(statistics.iterations)));
+    object.setValue("meanNs", ast::value(statistics.mean));
+    object.setValue("medianNs", ast::value(statistics.median));
+    object.setValue("minNs", ast::value(statistics.min));
+    object.setValue("stddevNs", ast::value(statistics.stddev));
+    if (benchmark.items != 0) {
+        object.setValue("itemsPerSecond",
+                        ast::value(static_cast<double>(benchmark.items) * 1e9 / statistics.median));
+    }
+    if (benchmark.bytes != 0) {
+        object.setValue("bytesPerSecond",
+                        ast::value(static_cast<double>(benchmark.bytes) * 1e9 / statistics.median));
+    }
+    Array samples{};
+    for (auto sample : statistics.samples) {
+        samples.emplace_back(ast::value(sample));
+    }
+    object.setValue("samplesNs", Value::make<ArrayValue>(std::move(samples)));
+    return ast::value(std::move(object));
+}
+
+size_t parseCount(std::string_view text) {
+    size_t count = 0;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), count);
+    if (error != std::errc{} || end != text.data() + text.size()) {
+        throw std::invalid_argument("expected a number instead of " + std::string{text});
+    }
+    return count;
+}
+
+std::vector<uint32_t> parseWeights(std::string_view text, size_t expected) {
+    std::vector<uint32_t> weights{};
+    while (true) {
+        const size_t comma = text.find(',');
+        weights.push_back(static_cast<uint32_t>(parseCount(text.substr(0, comma))));
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        text.remove_prefix(comma + 1);
+    }
+    if (weights.size() != expected) {
+        throw std::invalid_argument("expected " + std::to_string(expected) + " weights");
+    }
+    return weights;
+}
+
+SuiteOptions parseOptions(int argc, char** argv) {
+    SuiteOptions options{};
+    for (int index = 1; index < argc; ++index) {
+        std::string_view argument{argv[index]};
+        if (argument == "--help" || argument == "-h") {
+            std::cout << kUsage;
+            std::exit(0);
+        }
+        if (++index == argc) {
+            throw std::invalid_argument("missing value of " + std::string{argument});
+        }
+        std::string_view value{argv[index]};
+        if (argument == "--documents") {
+            options.documents = parseCount(value);
+        } else if (argument == "--width") {
+            options.corpus.width = parseCount(value);
+        } else if (argument == "--depth") {
+            options.corpus.depth = parseCount(value);
+        } else if (argument == "--array-length") {
+            options.corpus.arrayLength = parseCount(value);
+        } else if (argument == "--scalar-mix") {
+            auto weights = parseWeights(value, 4);
+            options.corpus.int32Weight = weights[0];
+            options.corpus.doubleWeight = weights[1];
+            options.corpus.stringWeight = weights[2];
+            options.corpus.boolWeight = weights[3];
+        } else if (argument == "--nesting-mix") {
+            auto weights = parseWeights(value, 2);
+            options.corpus.objectWeight = weights[0];
+            options.corpus.arrayWeight = weights[1];
+        } else if (argument == "--seed") {
+            options.corpus.seed = static_cast<uint32_t>(parseCount(value));
+        } else if (argument == "--samples") {
+            options.samples = std::max<size_t>(parseCount(value), 1);
+        } else if (argument == "--sample-ms") {
+            options.sampleMilliseconds = parseCount(value);
+        } else if (argument == "--filter") {
+            options.filter = value;
+        } else if (argument == "--output") {
+            options.output = value;
+        } else {
+            throw std::invalid_argument("unknown option " + std::string{argument});
+        }
+    }
+    return options;
+}
+
+int run(int argc, char** argv) {
+    const auto options = parseOptions(argc, argv);
+
+    CorpusGenerator generator{options.corpus};
+    const auto documents = generator.documents(options.documents);
+    // JSON text of the documents, which the expression grammar reads as value literals.
+    std::vector<std::string> sources{};
+    size_t sourceBytes = 0;
+    for (const auto& document : documents) {
+        appendJson(document, sources.emplace_back());
+        sourceBytes += sources.back().size();
+    }
+
+    Array results{};
+    for (const auto& benchmark : makeBenchmarks(documents, sources, sourceBytes)) {
+        const auto fullName = benchmark.group + ": " + benchmark.name;
+        if (fullName.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        std::cerr << fullName << std::flush;
+        const auto statistics = measure(benchmark, options);
+        std::cerr << "  " << statistics.median / 1e6 << " ms\n";
+        results.emplace_back(toValue(benchmark, statistics));
+    }
+
+    Object report{};
+    report.setValue("corpus", toValue(options.corpus, options.documents, sourceBytes));
+    report.setValue("benchmarks", Value::make<ArrayValue>(std::move(results)));
+    std::string json{};
+    appendJson(ast::value(std::move(report)), json);
+    json.push_back('\n');
+
+    if (options.output.empty()) {
+        std::cout << json;
+    } else {
+        std::ofstream output{options.output};
+        output << json;
+        if (!output) {
+            throw std::runtime_error("cannot write " + options.output);
+        }
+    }
+    return 0;
+}
+}  // namespace
+}  // namespace mqlpath
+
+int main(int argc, char** argv) {
+    try {
+        return mqlpath::run(argc, argv);
+    } catch (const std::exception& error) {
+        std::cerr << "mqlpath-bench: " << error.what() << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,124 @@
+#include "mqlpath/eval_pipeline.h"
+#include "mqlpath/parse.h"
+#include "mqlpath/prepared_path.h"
+#include <charconv>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mqlpath {
+namespace {
+constexpr std::string_view kUsage = R"(Usage: mqlpath-eval [options] <path> [<input file>]
+
+Evaluates the path over every document of the input file, or of stdin if it is missing, and
+writes the results to stdout in the order of the documents. A document store is mapped, so it
+must be given as a file.
+
+Options:
+  --input json|bson|store format of the input, json for newline-delimited JSON (default json)
+  --output json|bson|store
+                          format of the results (default json)
+  --eval-workers <n>      threads evaluating the path (default: one per core)
+  --parse-workers <n>     threads parsing the input (default 1)
+  --serialize-workers <n> threads serializing the results (default 1)
+  --batch-bytes <n>       input bytes per batch (default 1048576)
+  --queue-capacity <n>    batches waiting between two stages (default 8)
+)";
+
+StreamFormat parseFormat(std::string_view text) {
+    if (text == "json") {
+        return StreamFormat::Json;
+    }
+    if (text == "bson") {
+        return StreamFormat::Bson;
+    }
+    if (text == "store") {
+        return StreamFormat::Store;
+    }
+    throw std::invalid_argument("unknown format " + std::string{text});
+}
+
+size_t parseCount(std::string_view text) {
+    size_t count = 0;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), count);
+    if (error != std::errc{} || end != text.data() + text.size() || count == 0) {
+        throw std::invalid_argument("expected a positive number instead of " + std::string{text});
+    }
+    return count;
+}
+
+int run(int argc, char** argv) {
+    PipelineOptions options{};
+    std::vector<std::string_view> arguments{};
+    for (int index = 1; index < argc; ++index) {
+        std::string_view argument{argv[index]};
+        if (argument == "--help" || argument == "-h") {
+            std::cout << kUsage;
+            return 0;
+        }
+        if (!argument.starts_with("--")) {
+            arguments.push_back(argument);
+            continue;
+        }
+        if (++index == argc) {
+            throw std::invalid_argument("missing value of " + std::string{argument});
+        }
+        std::string_view value{argv[index]};
+        if (argument == "--input") {
+            options.inputFormat = parseFormat(value);
+        } else if (argument == "--output") {
+            options.outputFormat = parseFormat(value);
+        } else if (argument == "--eval-workers") {
+            options.evalWorkers = parseCount(value);
+        } else if (argument == "--parse-workers") {
+            options.parseWorkers = parseCount(value);
+        } else if (argument == "--serialize-workers") {
+            options.serializeWorkers = parseCount(value);
+        } else if (argument == "--batch-bytes") {
+            options.batchBytes = parseCount(value);
+        } else if (argument == "--queue-capacity") {
+            options.queueCapacity = parseCount(value);
+        } else {
+            throw std::invalid_argument("unknown option " + std::string{argument});
+        }
+    }
+    if (arguments.empty() || arguments.size() > 2) {
+        std::cerr << kUsage;
+        return 2;
+    }
+
+    PreparedPath path{parsePath(std::string{arguments[0]})};
+    std::ios::sync_with_stdio(false);
+    if (arguments.size() == 1) {
+        runPipeline(path, std::cin, std::cout, options);
+        return 0;
+    }
+
+    if (options.inputFormat == StreamFormat::Store) {
+        // Mapped instead of read, so the documents are not copied into the process.
+        DocumentStore input{std::string{arguments[1]}};
+        runPipeline(path, input, std::cout, options);
+        return 0;
+    }
+    std::ifstream input{std::string{arguments[1]}, std::ios::binary};
+    if (!input) {
+        throw std::runtime_error("cannot open " + std::string{arguments[1]});
+    }
+    runPipeline(path, input, std::cout, options);
+    return 0;
+}
+}  // namespace
+}  // namespace mqlpath
+
+int main(int argc, char** argv) {
+    try {
+        return mqlpath::run(argc, argv);
+    } catch (const std::exception& error) {
+        std::cerr << "mqlpath-eval: " << error.what() << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <system_error>
+
+namespace mqlpath {
+/**
+ * std::from_chars for a decimal number, "-1.5e10" say, which rounds values too small for a
+ * double to zero like strtod does. Only values too large for a double are result_out_of_range,
+ * while from_chars reports both alike and leaves 'result' unchanged.
+ */
+inline std::from_chars_result parseDouble(const char* first, const char* last, double& result) {
+    auto parsed = std::from_chars(first, last, result);
+    if (parsed.ec != std::errc::result_out_of_range) {
+        return parsed;
+    }
+
+    // The number only rounds to zero or infinity, so the power of ten of its first significant
+    // digit tells which one.
+    const bool negative = first != parsed.ptr && *first == '-';
+    int64_t magnitude = 0;
+    bool significant = false;
+    bool fraction = false;
+    const char* current = negative ? first + 1 : first;
+    for (; current != parsed.ptr && *current != 'e' && *current != 'E'; ++current) {
+        if (*current == '.') {
+            fraction = true;
+        } else if (significant) {
+            magnitude += fraction ? 0 : 1;
+        } else if (*current != '0' || fraction) {
+            significant = *current != '0';
+            magnitude -= fraction ? 1 : 0;
+        }
+    }
+    if (current != parsed.ptr) {
+        ++current;
+        const bool negativeExponent = *current == '-';
+        if (*current == '-' || *current == '+') {
+            ++current;
+        }
+        // Exponents beyond any double only need to keep their sign.
+        int64_t exponent = 0;
+        for (; current != parsed.ptr; ++current) {
+            exponent = exponent < 100000 ? exponent * 10 + (*current - '0') : exponent;
+        }
+        magnitude += negativeExponent ? -exponent : exponent;
+    }
+
+    if (magnitude >= 0) {
+        return parsed;
+    }
+    result = negative ? -0.0 : 0.0;
+    parsed.ec = std::errc{};
+    return parsed;
+}
+}  // namespace mqlpath
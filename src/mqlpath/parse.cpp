@@ -0,0 +1,32 @@
+#include "mqlpath/parse.h"
+#include <lexer.h>
+#include <parser.h>
+#include <sstream>
+#include <stdexcept>
+
+namespace mqlpath {
+namespace {
+void parse(const std::string& code, Driver& driver) {
+    Lexer lexer(code);
+    Parser parser{lexer, &driver};
+    if (parser.parse() != 0 || driver.getErrors().hasErrors()) {
+        std::ostringstream errors{};
+        errors << driver.getErrors();
+        throw std::invalid_argument(errors.str());
+    }
+}
+}  // namespace
+
+Expression parseExpression(const std::string& code) {
+    Driver driver{};
+    parse(code, driver);
+    return driver.getAST();
+}
+
+Path parsePath(const std::string& code) {
+    Driver driver{};
+    driver.startWithPath();
+    parse(code, driver);
+    return driver.getPath();
+}
+}  // namespace mqlpath
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "mqlpath/ast.h"
+#include <string>
+
+namespace mqlpath {
+/**
+ * Parses an expression. Throws std::invalid_argument listing the errors if the text is not a
+ * valid expression.
+ */
+Expression parseExpression(const std::string& code);
+
+/**
+ * Parses a path on its own, as it would appear after EvalPath.
+ */
+Path parsePath(const std::string& code);
+}  // namespace mqlpath
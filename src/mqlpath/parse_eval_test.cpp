@@ -1,4 +1,6 @@
 #include "mqlpath/ast_eval.h"
+#include "mqlpath/path_optimizer.h"
+#include "mqlpath/path_program.h"
 #include <catch2/catch_message.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <iostream>
@@ -166,4 +168,45 @@ TEST_CASE("Parse and Evaluation integration tests") {
     }
 }
 
-}  // namespace mqlpath
\ No newline at end of file
+TEST_CASE("Compiled path programs match PathEval") {
+
+    for (const auto& strTestCase : testCases) {
+        INFO(strTestCase);
+
+        auto testCase = parseTestCase(strTestCase);
+        auto expr = parse(testCase.expression);
+        auto evalPath = expr.cast<EvalPath>();
+        REQUIRE(evalPath != nullptr);
+
+        auto program = compile(evalPath->path);
+        INFO(program);
+
+        auto actualDocument = program.run(evaluate(evalPath->expr));
+        auto expectedDocument = evaluate(expr);
+
+        REQUIRE(expectedDocument == actualDocument);
+    }
+}
+
+TEST_CASE("Optimized paths match PathEval") {
+
+    for (const auto& strTestCase : testCases) {
+        INFO(strTestCase);
+
+        auto testCase = parseTestCase(strTestCase);
+        auto expr = parse(testCase.expression);
+        auto evalPath = expr.cast<EvalPath>();
+        REQUIRE(evalPath != nullptr);
+
+        auto optimized = optimize(evalPath->path);
+        INFO(optimized);
+
+        auto actualDocument =
+            evaluate(Expression::make<EvalPath>(optimized, evalPath->expr, evalPath->location));
+        auto expectedDocument = evaluate(expr);
+
+        REQUIRE(expectedDocument == actualDocument);
+    }
+}
+
+}  // namespace mqlpath
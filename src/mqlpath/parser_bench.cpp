@@ -0,0 +1,35 @@
+#include "mqlpath/corpus_generator.h"
+#include "mqlpath/json.h"
+#include "mqlpath/parse.h"
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+namespace mqlpath {
+TEST_CASE("Parsing a large constant literal", "[parser][benchmark]") {
+    // An array of corpus documents, which the grammar accepts as JSON.
+    CorpusGenerator generator{CorpusOptions{}};
+    std::string source{"["};
+    for (const auto& document : generator.documents(500)) {
+        if (source.size() > 1) {
+            source += ",\n";
+        }
+        appendJson(document, source);
+    }
+    source += "]";
+
+    std::string singleLine = source;
+    for (auto& c : singleLine) {
+        c = c == '\n' ? ' ' : c;
+    }
+
+    // Divide the bytes by the time for the throughput.
+    BENCHMARK("parse 500 documents, one per line, " + std::to_string(source.size()) + " bytes") {
+        return parseExpression(source);
+    };
+
+    BENCHMARK("parse 500 documents on one line") {
+        return parseExpression(singleLine);
+    };
+}
+}  // namespace mqlpath
@@ -1,9 +1,11 @@
 #include "mqlpath/ast.h"
 #include "mqlpath/ast_make.h"
+#include "mqlpath/parse.h"
 #include "mqlpath/value.h"
 #include <catch2/catch_test_macros.hpp>
 #include <lexer.h>
 #include <parser.h>
+#include <stdexcept>
 
 namespace mqlpath {
 namespace {
@@ -167,4 +169,53 @@ TEST_CASE("EvalPath Traverse", "[parser]") {
     auto expectedExpr = ast::evalPath(ast::traverse(ast::id()), ast::expr(Object{}));
     REQUIRE(expectedExpr == expr);
 }
+
+TEST_CASE("number limits", "[parser]") {
+    REQUIRE(ast::expr(std::vector<int32_t>{2147483647, 0}) == parse("[2147483647, 000]"));
+    REQUIRE(ast::expr(-0.25) == parse("-.25"));
+    REQUIRE(ast::expr(-2147483648.0) == parse("-2147483648"));
+    REQUIRE_THROWS_AS(parseExpression("2147483648"), std::invalid_argument);
+    REQUIRE_THROWS_AS(parseExpression("EvalPath At 2147483648 Id []"), std::invalid_argument);
+    REQUIRE(ast::expr(0.0) == parse("0." + std::string(400, '0') + "1"));
+    REQUIRE_THROWS_AS(parseExpression("1" + std::string(400, '0') + ".0"), std::invalid_argument);
+}
+
+TEST_CASE("errors", "[parser]") {
+    auto message = [](const std::string& code) {
+        try {
+            parseExpression(code);
+        } catch (const std::invalid_argument& error) {
+            return std::string{error.what()};
+        }
+        return std::string{};
+    };
+
+    REQUIRE(message("[1, \"ab") ==
+            "1 errors.\n[parser] :1.5-7: Unterminated string \"ab\n");
+
+    // Columns stay exact far into a long line.
+    std::string code = "[";
+    for (int i = 0; i < 5000; ++i) {
+        code += "1, ";
+    }
+    REQUIRE(message(code + "xy]") ==
+            "1 errors.\n[parser] :1.15002-15003: syntax error, unexpected identifier\n");
+}
+
+TEST_CASE("bare paths", "[parser]") {
+    REQUIRE(ast::get("a", ast::id()) == parsePath("Get a Id // the a field"));
+    REQUIRE(ast::compose(ast::obj(), ast::constPath(1)) == parsePath("Obj * Const 1"));
+
+    // Errors point into the path as it was written.
+    try {
+        parsePath("Get a (Const 1");
+        FAIL("the path is incomplete");
+    } catch (const std::invalid_argument& error) {
+        REQUIRE(std::string{error.what()} ==
+                "1 errors.\n[parser] :1.15: syntax error, unexpected end of file, "
+                "expecting '*' or ')'\n");
+    }
+    REQUIRE_THROWS_AS(parsePath("Get a Id Nothing"), std::invalid_argument);
+    REQUIRE_THROWS_AS(parsePath(""), std::invalid_argument);
+}
 }  // namespace mqlpath
@@ -0,0 +1,189 @@
+#include "mqlpath/path_dependencies.h"
+#include <utility>
+
+namespace mqlpath {
+namespace {
+/**
+ * Levels of nested arrays for which Traverse computes the set of their elements. Deeper arrays are
+ * read whole.
+ */
+constexpr int kMaxTraverseDepth = 4;
+
+/**
+ * The set 'objects' for the values which are not arrays, with 'elements' for those which are.
+ */
+FieldSet withElements(FieldSet objects, FieldSet elements) {
+    if (objects.isEmpty() && elements.isEmpty()) {
+        return objects;
+    }
+    objects.setElements(std::move(elements));
+    return objects;
+}
+
+/**
+ * Computes the set a path reads from the set of its output which is needed. Nothing of the input
+ * is needed for an output which is not, so every step passes the empty set through.
+ */
+struct ReadSet {
+    FieldSet read(const Path& path, const FieldSet& output) {
+        if (output.isEmpty()) {
+            return {};
+        }
+        return path.visit(*this, output);
+    }
+
+    FieldSet operator()(const Path&, const IdPath&, const FieldSet& output) {
+        return output;
+    }
+
+    FieldSet operator()(const Path&, const ConstPath&, const FieldSet&) {
+        return {};
+    }
+
+    FieldSet operator()(const Path&, const LambdaPath&, const FieldSet&) {
+        return {};
+    }
+
+    // Default, Obj and Arr pass their input on or replace it, which depends on its type alone.
+    FieldSet operator()(const Path&, const DefaultPath&, const FieldSet& output) {
+        return output;
+    }
+
+    FieldSet operator()(const Path&, const ObjPath&, const FieldSet& output) {
+        return output;
+    }
+
+    FieldSet operator()(const Path&, const ArrPath&, const FieldSet& output) {
+        return output;
+    }
+
+    FieldSet operator()(const Path&, const DropPath& path, const FieldSet& output) {
+        auto result = output;
+        for (const auto& fieldName : path.fieldNames) {
+            result.setField(fieldName, {});
+        }
+        return result;
+    }
+
+    FieldSet operator()(const Path&, const KeepPath& path, const FieldSet& output) {
+        // Arrays and scalars are kept as they are.
+        auto result = FieldSet::shape();
+        for (const auto& fieldName : path.fieldNames) {
+            result.setField(fieldName, output.getField(fieldName));
+        }
+        result.setElements(output.getElements());
+        return result;
+    }
+
+    FieldSet operator()(const Path&, const FieldPath& path, const FieldSet& output) {
+        const auto& field = output.getField(path.fieldName);
+        auto inner = read(path.path, field);
+        if (inner.isEmpty() && !field.isEmpty()) {
+            // A field which is present keeps its position when it is replaced.
+            inner = FieldSet::shape();
+        }
+        auto result = output;
+        result.setField(path.fieldName, std::move(inner));
+        return result;
+    }
+
+    FieldSet operator()(const Path&, const GetPath& path, const FieldSet& output) {
+        auto inner = read(path.path, output);
+        if (inner.isEmpty()) {
+            return inner;
+        }
+        auto result = FieldSet::shape();
+        result.setField(path.fieldName, std::move(inner));
+        return result;
+    }
+
+    FieldSet operator()(const Path&, const AtPath& path, const FieldSet& output) {
+        return withElements(FieldSet{}, read(path.path, output));
+    }
+
+    FieldSet operator()(const Path&, const TraversePath& path, const FieldSet& output) {
+        // The inner path runs over a value which is not an array, and over the elements of an
+        // array which are not arrays themselves, while nested arrays are traversed again.
+        auto result = withElements(
+            read(path.path, output),
+            readElements(path.path, output.getElements(), kMaxTraverseDepth));
+        // Even an inner path which reads nothing yields an array only for an array.
+        return result.isEmpty() ? FieldSet::shape() : result;
+    }
+
+    FieldSet operator()(const Path&, const CompositionPath& path, const FieldSet& output) {
+        return read(path.left, read(path.right, output));
+    }
+
+    FieldSet readElements(const Path& path, const FieldSet& output, int depth) {
+        if (output.isEmpty()) {
+            return {};
+        }
+        if (depth == 0) {
+            return FieldSet::all();
+        }
+        auto result = withElements(read(path, output),
+                                   readElements(path, output.getElements(), depth - 1));
+        // Even an inner path which reads nothing yields one output element per input element.
+        return result.isEmpty() ? FieldSet::shape() : result;
+    }
+};
+
+struct WriteSet {
+    template <typename T>
+    FieldSet operator()(const Path&, const T&) {
+        return FieldSet::all();
+    }
+
+    FieldSet operator()(const Path&, const IdPath&) {
+        return {};
+    }
+
+    FieldSet operator()(const Path&, const DropPath& path) {
+        auto result = FieldSet::shape();
+        for (const auto& fieldName : path.fieldNames) {
+            result.setField(fieldName, FieldSet::all());
+        }
+        return result;
+    }
+
+    FieldSet operator()(const Path&, const KeepPath& path) {
+        auto result = FieldSet::otherFields();
+        for (const auto& fieldName : path.fieldNames) {
+            result.setField(fieldName, {});
+        }
+        return result;
+    }
+
+    FieldSet operator()(const Path&, const FieldPath& path) {
+        auto inner = path.path.visit(*this);
+        if (inner.isEmpty()) {
+            return inner;
+        }
+        auto result = FieldSet::shape();
+        result.setField(path.fieldName, std::move(inner));
+        return result;
+    }
+
+    FieldSet operator()(const Path&, const TraversePath& path) {
+        // Elements for which the inner path yields Nothing are left out, which moves the others,
+        // and Nothing elements are dropped even by Id.
+        return withElements(path.path.visit(*this), FieldSet::all());
+    }
+
+    FieldSet operator()(const Path&, const CompositionPath& path) {
+        auto result = path.left.visit(*this);
+        result.unite(path.right.visit(*this));
+        return result;
+    }
+};
+}  // namespace
+
+FieldSet getReadSet(const Path& path) {
+    return ReadSet{}.read(path, FieldSet::all());
+}
+
+FieldSet getWriteSet(const Path& path) {
+    return path.visit(WriteSet{});
+}
+}  // namespace mqlpath
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "mqlpath/ast.h"
+#include "mqlpath/field_set.h"
+
+namespace mqlpath {
+/**
+ * The parts of its input which the result of the path depends on: evaluating the path over the
+ * input projected to this set yields the same result as over the whole input. Every step is
+ * analyzed from the parts of its output which the following steps need, so e.g. "Field a (Get
+ * b) * Get a" reads a.b alone, while Id, Drop and the fields a Keep lists read their input whole
+ * unless a later step narrows them. At reads every element, nested arrays below a few levels of
+ * Traverse are read whole, and Const and Lambda read nothing.
+ */
+FieldSet getReadSet(const Path& path);
+
+/**
+ * The parts of an object input which the path may change, so that the result shares all other
+ * parts with the input: Field writes the parts of its field that its inner path writes, Drop
+ * the dropped fields and Keep all others. Steps which do not rebuild their input field by field,
+ * such as Get, Const or Default, write it whole, and Traverse writes all elements of an array.
+ */
+FieldSet getWriteSet(const Path& path);
+}  // namespace mqlpath
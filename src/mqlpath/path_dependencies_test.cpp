@@ -0,0 +1,112 @@
+#include "mqlpath/ast_eval.h"
+#include "mqlpath/ast_make.h"
+#include "mqlpath/json.h"
+#include "mqlpath/path_dependencies.h"
+#include "mqlpath/random_generator.h"
+#include <catch2/catch_message.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <sstream>
+#include <utility>
+
+namespace mqlpath {
+namespace {
+std::string toString(const FieldSet& set) {
+    std::ostringstream os;
+    os << set;
+    return os.str();
+}
+}  // namespace
+
+TEST_CASE("read sets follow Get and Field", "[path_dependencies]") {
+    REQUIRE(toString(getReadSet(ast::id())) == "all");
+    REQUIRE(toString(getReadSet(ast::constPath(1))) == "none");
+    REQUIRE(toString(getReadSet(ast::get("a", ast::get("b", ast::id())))) == "{a: {b: all}}");
+    REQUIRE(toString(getReadSet(ast::get("a", ast::constPath(1)))) == "none");
+    REQUIRE(toString(getReadSet(ast::at(0, ast::get("a", ast::id())))) == "{[]: {a: all}}");
+
+    // The field is rewritten from b, and only the new field is used.
+    auto path = ast::compose(ast::field("a", ast::get("b", ast::id())), ast::get("a", ast::id()));
+    REQUIRE(toString(getReadSet(path)) == "{a: {b: all}}");
+    REQUIRE(toString(getReadSet(ast::field("a", ast::constPath(1)))) ==
+            "{a: {}, *: all, []: all}");
+}
+
+TEST_CASE("read sets follow Keep and Drop", "[path_dependencies]") {
+    REQUIRE(toString(getReadSet(ast::drop({"a", "b"}))) == "{a: none, b: none, *: all, []: all}");
+    REQUIRE(toString(getReadSet(ast::keep({"a", "b"}))) == "{a: all, b: all, []: all}");
+
+    auto keep = ast::compose(ast::keep({"a", "b"}), ast::get("b", ast::get("c", ast::id())));
+    REQUIRE(toString(getReadSet(keep)) == "{b: {c: all}}");
+    auto drop = ast::compose(ast::drop({"a"}), ast::get("a", ast::id()));
+    REQUIRE(toString(getReadSet(drop)) == "{}");
+}
+
+TEST_CASE("read sets of Traverse cover the elements", "[path_dependencies]") {
+    auto set = getReadSet(ast::traverse(ast::get("a", ast::id())));
+    REQUIRE(set.getField("a").isAll());
+    REQUIRE(set.getField("b").isEmpty());
+    REQUIRE(set.getElements().getField("a").isAll());
+    REQUIRE(set.getElements().getElements().getField("a").isAll());
+    REQUIRE(set.getElements().getElements().getField("b").isEmpty());
+
+    // The elements are counted even if they are not read.
+    auto constant = getReadSet(ast::traverse(ast::constPath(1)));
+    REQUIRE(toString(constant.getElements()) == "{[]: {[]: {[]: {[]: all}}}}");
+
+    // Whether the input is an array is read even if no element is needed.
+    auto path = ast::get("x",
+                         ast::compose(ast::traverse(ast::constPath(parseJson(R"({"a": 1})"))),
+                                      ast::get("a", ast::id())));
+    auto reads = getReadSet(path);
+    REQUIRE(toString(reads) == "{x: {}}");
+    auto document = parseJson(R"({"x": [5]})");
+    REQUIRE(evaluate(path, reads.project(document)) == evaluate(path, document));
+}
+
+TEST_CASE("write sets cover the changed fields", "[path_dependencies]") {
+    REQUIRE(toString(getWriteSet(ast::id())) == "none");
+    REQUIRE(toString(getWriteSet(ast::get("a", ast::id()))) == "all");
+    REQUIRE(toString(getWriteSet(ast::field("a", ast::field("b", ast::constPath(1))))) ==
+            "{a: {b: all}}");
+    REQUIRE(toString(getWriteSet(ast::field("a", ast::id()))) == "none");
+    REQUIRE(toString(getWriteSet(ast::drop({"a"}))) == "{a: all}");
+    REQUIRE(toString(getWriteSet(ast::keep({"a"}))) == "{a: none, *: all}");
+    REQUIRE(toString(getWriteSet(ast::compose(ast::drop({"a"}), ast::field("b", ast::obj())))) ==
+            "{a: all, b: all}");
+    REQUIRE(toString(getWriteSet(ast::traverse(ast::field("a", ast::constPath(1))))) ==
+            "{a: all, []: all}");
+}
+
+TEST_CASE("paths yield the same results over their read sets", "[path_dependencies]") {
+    RandomGenerator generator{20241016};
+    for (int i = 0; i < 2000; ++i) {
+        auto path = generator.path(4);
+        auto reads = getReadSet(path);
+        auto writes = getWriteSet(path);
+        INFO(path);
+        INFO(reads);
+        INFO(writes);
+        for (int j = 0; j < 5; ++j) {
+            auto document = generator.value(3);
+            INFO(document);
+            auto result = evaluate(path, document);
+            REQUIRE(evaluate(path, reads.project(document)) == result);
+
+            if (writes.isEmpty()) {
+                REQUIRE(result == document);
+            } else if (isObject(document) && isObject(result)) {
+                const auto& input = std::as_const(document).cast<ObjectValue>()->object;
+                const auto& output = std::as_const(result).cast<ObjectValue>()->object;
+                for (const auto* object : {&input, &output}) {
+                    for (const auto& fieldName : object->getNames()) {
+                        if (writes.getField(fieldName).isEmpty()) {
+                            INFO(fieldName);
+                            REQUIRE(input.getValue(fieldName) == output.getValue(fieldName));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+}  // namespace mqlpath
@@ -0,0 +1,594 @@
+#include "mqlpath/path_optimizer.h"
+#include "mqlpath/ast_eval.h"
+#include "mqlpath/ast_make.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace mqlpath {
+namespace {
+/**
+ * Bit set of the kinds of values that may flow between two steps of a composition chain.
+ */
+enum Kind : uint8_t {
+    kNothing = 1,
+    kScalar = 2,
+    kArray = 4,
+    kObject = 8,
+    kAny = 15,
+};
+
+struct ValueKind {
+    uint8_t operator()(const Value&, const NothingValue&) {
+        return kNothing;
+    }
+
+    uint8_t operator()(const Value&, const ScalarValue&) {
+        return kScalar;
+    }
+
+    uint8_t operator()(const Value&, const ArrayValue&) {
+        return kArray;
+    }
+
+    uint8_t operator()(const Value&, const ObjectValue&) {
+        return kObject;
+    }
+};
+
+uint8_t kindsOf(const Expression& expr) {
+    if (auto constant = expr.cast<ConstantValue>(); constant != nullptr) {
+        return constant->value.visit(ValueKind{});
+    }
+    return kAny;
+}
+
+bool contains(const std::vector<FieldName>& fieldNames, const FieldName& fieldName) {
+    return std::find(begin(fieldNames), end(fieldNames), fieldName) != end(fieldNames);
+}
+
+class PathOptimizer {
+public:
+    template <typename T>
+    Path operator()(const Path& path, const T&) {
+        return path;
+    }
+
+    Path operator()(const Path&, const FieldPath& path) {
+        auto inner = path.path.visit(*this);
+        if (inner.is<IdPath>()) {
+            // Writing back the field's own value does not change the input.
+            return inner;
+        }
+        return Path::make<FieldPath>(path.fieldName, std::move(inner));
+    }
+
+    Path operator()(const Path&, const GetPath& path) {
+        return Path::make<GetPath>(path.fieldName, path.path.visit(*this));
+    }
+
+    Path operator()(const Path&, const AtPath& path) {
+        return Path::make<AtPath>(path.index, path.path.visit(*this));
+    }
+
+    Path operator()(const Path&, const TraversePath& path) {
+        return Path::make<TraversePath>(path.path.visit(*this));
+    }
+
+    Path operator()(const Path& path, const CompositionPath&) {
+        std::vector<Path> steps{};
+        flatten(path, steps);
+        return optimizeChain(std::move(steps));
+    }
+
+private:
+    /**
+     * Appends the optimized steps of the composition chain to 'steps'.
+     */
+    void flatten(const Path& path, std::vector<Path>& steps) {
+        if (auto composition = path.cast<CompositionPath>(); composition != nullptr) {
+            flatten(composition->left, steps);
+            flatten(composition->right, steps);
+            return;
+        }
+
+        auto step = path.visit(*this);
+        if (step.is<CompositionPath>()) {
+            appendSteps(std::move(step), steps);
+        } else {
+            steps.emplace_back(std::move(step));
+        }
+    }
+
+    /**
+     * Appends the steps of an already optimized path to 'steps'.
+     */
+    static void appendSteps(Path path, std::vector<Path>& steps) {
+        if (auto composition = path.cast<CompositionPath>(); composition != nullptr) {
+            appendSteps(std::move(composition->left), steps);
+            appendSteps(std::move(composition->right), steps);
+        } else {
+            steps.emplace_back(std::move(path));
+        }
+    }
+
+    Path optimizeChain(std::vector<Path> steps) {
+        std::vector<Path> chain{};
+        uint8_t kinds = kAny;
+
+        for (auto& step : steps) {
+            if (step.is<IdPath>()) {
+                continue;
+            }
+
+            if (auto constPath = step.cast<ConstPath>(); constPath != nullptr) {
+                // The result of everything before Const is discarded.
+                kinds = kindsOf(constPath->expr);
+                chain.clear();
+                chain.emplace_back(std::move(step));
+            } else if (auto defaultPath = step.cast<DefaultPath>(); defaultPath != nullptr) {
+                if ((kinds & kNothing) == 0) {
+                    continue;
+                }
+                kinds = (kinds & ~kNothing) | kindsOf(defaultPath->expr);
+                chain.emplace_back(std::move(step));
+            } else if (step.is<ObjPath>() || step.is<ArrPath>()) {
+                const uint8_t kind = step.is<ObjPath>() ? kObject : kArray;
+                if ((kinds & ~(kNothing | kind)) == 0) {
+                    continue;
+                }
+                if ((kinds & kind) == 0) {
+                    kinds = kNothing;
+                    chain.clear();
+                    chain.emplace_back(ast::constPath(ast::nothing()));
+                    continue;
+                }
+                kinds = (kinds & kind) | kNothing;
+                chain.emplace_back(std::move(step));
+            } else if (auto drop = step.cast<DropPath>(); drop != nullptr) {
+                if (!chain.empty() && chain.back().is<DropPath>()) {
+                    auto fieldNames = chain.back().cast<DropPath>()->fieldNames;
+                    for (const auto& fieldName : drop->fieldNames) {
+                        if (!contains(fieldNames, fieldName)) {
+                            fieldNames.emplace_back(fieldName);
+                        }
+                    }
+                    chain.back() = Path::make<DropPath>(std::move(fieldNames));
+                } else {
+                    chain.emplace_back(std::move(step));
+                }
+            } else if (auto keep = step.cast<KeepPath>(); keep != nullptr) {
+                if (!chain.empty() && chain.back().is<KeepPath>()) {
+                    std::vector<FieldName> fieldNames{};
+                    for (const auto& fieldName : chain.back().cast<KeepPath>()->fieldNames) {
+                        if (contains(keep->fieldNames, fieldName)) {
+                            fieldNames.emplace_back(fieldName);
+                        }
+                    }
+                    chain.back() = Path::make<KeepPath>(std::move(fieldNames));
+                } else {
+                    chain.emplace_back(std::move(step));
+                }
+            } else if (step.is<FieldPath>()) {
+                kinds |= kObject;
+                chain.emplace_back(std::move(step));
+            } else {
+                kinds = kAny;
+                chain.emplace_back(std::move(step));
+            }
+        }
+
+        return sinkIntoGets(std::move(chain));
+    }
+
+    /**
+     * Builds the composition of the chain, moving the steps which follow a Get or At into its
+     * inner path: Get a P * Q is equivalent to Get a (P * Q).
+     */
+    Path sinkIntoGets(std::vector<Path> chain) {
+        if (chain.empty()) {
+            return ast::id();
+        }
+
+        Path result = std::move(chain.back());
+        for (size_t i = chain.size() - 1; i-- > 0;) {
+            auto& step = chain[i];
+            if (auto get = step.cast<GetPath>(); get != nullptr) {
+                result =
+                    Path::make<GetPath>(get->fieldName, sinkInto(get->path, std::move(result)));
+            } else if (auto at = step.cast<AtPath>(); at != nullptr) {
+                result = Path::make<AtPath>(at->index, sinkInto(at->path, std::move(result)));
+            } else {
+                result = Path::make<CompositionPath>(std::move(step), std::move(result));
+            }
+        }
+        return result;
+    }
+
+    Path sinkInto(const Path& inner, Path rest) {
+        std::vector<Path> steps{};
+        appendSteps(inner, steps);
+        appendSteps(std::move(rest), steps);
+        return optimizeChain(std::move(steps));
+    }
+};
+
+/**
+ * Shape of the values an expression may evaluate to.
+ */
+ValueShape shapeOf(const Expression& expr) {
+    if (auto constant = expr.cast<ConstantValue>(); constant != nullptr) {
+        return ValueShape::of(constant->value);
+    }
+    return ValueShape{};
+}
+
+/**
+ * Input shape of the inner path of Get or At: the shape of the field or element of the input's
+ * objects or arrays, and Nothing for inputs of any other kind.
+ */
+ValueShape innerShape(const ValueShape& input, uint8_t kind, const ValueShape& inner) {
+    ValueShape result{0};
+    if (input.mayBe(kind)) {
+        result = inner;
+    }
+    if (!input.isOnly(kind)) {
+        result.unite(ValueShape{ValueShape::kNothing});
+    }
+    return result;
+}
+
+/**
+ * Levels of nested arrays whose element shapes are followed by Traverse. The elements of deeper
+ * arrays are taken to be of any shape.
+ */
+constexpr int kMaxTraverseDepth = 4;
+
+/**
+ * Infers the shape of the values between the steps of a path from the shape of its input, and
+ * removes the steps and guards whose outcome the shapes decide. Every visit returns the rewritten
+ * path and sets 'output' to the shape of its results.
+ */
+class ShapeSpecializer {
+public:
+    Path specialize(const Path& path, const ValueShape& input, ValueShape& output) {
+        return path.visit(*this, input, output);
+    }
+
+    Path operator()(const Path& path, const IdPath&, const ValueShape& input, ValueShape& output) {
+        output = input;
+        return path;
+    }
+
+    Path operator()(const Path& path,
+                    const ConstPath& constPath,
+                    const ValueShape&,
+                    ValueShape& output) {
+        output = shapeOf(constPath.expr);
+        return path;
+    }
+
+    Path operator()(const Path& path,
+                    const DefaultPath& defaultPath,
+                    const ValueShape& input,
+                    ValueShape& output) {
+        if (!input.mayBe(ValueShape::kNothing)) {
+            output = input;
+            return ast::id();
+        }
+        output = shapeOf(defaultPath.expr);
+        if (input.isOnly(ValueShape::kNothing)) {
+            return ast::constPath(defaultPath.expr);
+        }
+        auto present = input;
+        present.restrict(~ValueShape::kNothing);
+        output.unite(present);
+        return path;
+    }
+
+    Path operator()(const Path& path, const LambdaPath&, const ValueShape&, ValueShape& output) {
+        output = ValueShape{ValueShape::kNothing};
+        return path;
+    }
+
+    Path operator()(const Path& path, const ObjPath&, const ValueShape& input, ValueShape& output) {
+        return guard(path, ValueShape::kObject, input, output);
+    }
+
+    Path operator()(const Path& path, const ArrPath&, const ValueShape& input, ValueShape& output) {
+        return guard(path, ValueShape::kArray, input, output);
+    }
+
+    Path operator()(const Path& path,
+                    const DropPath& drop,
+                    const ValueShape& input,
+                    ValueShape& output) {
+        output = input;
+        if (!input.mayBe(ValueShape::kObject) ||
+            std::all_of(drop.fieldNames.begin(), drop.fieldNames.end(), [&](const auto& name) {
+                return input.getField(name).isOnly(ValueShape::kNothing);
+            })) {
+            // There is no object, or none of the fields to drop.
+            return ast::id();
+        }
+        for (const auto& fieldName : drop.fieldNames) {
+            output.setField(fieldName, ValueShape{ValueShape::kNothing});
+        }
+        return path;
+    }
+
+    Path operator()(const Path& path,
+                    const KeepPath& keep,
+                    const ValueShape& input,
+                    ValueShape& output) {
+        auto isKept = [&](const FieldName& fieldName) {
+            return contains(keep.fieldNames, fieldName) ||
+                input.getField(fieldName).isOnly(ValueShape::kNothing);
+        };
+        output = input;
+        if (!input.mayBe(ValueShape::kObject) ||
+            (input.getOtherFields().isOnly(ValueShape::kNothing) &&
+             std::all_of(input.getFieldNames().begin(), input.getFieldNames().end(), isKept))) {
+            // There is no object, or no field which is not kept.
+            return ast::id();
+        }
+
+        ValueShape kept{input.getKinds()};
+        if (input.mayBe(ValueShape::kArray)) {
+            kept.setElements(input.getElements());
+        }
+        kept.setOtherFields(ValueShape{ValueShape::kNothing});
+        for (const auto& fieldName : keep.fieldNames) {
+            kept.setField(fieldName, input.getField(fieldName));
+        }
+        output = std::move(kept);
+        return path;
+    }
+
+    Path operator()(const Path&,
+                    const FieldPath& fieldPath,
+                    const ValueShape& input,
+                    ValueShape& output) {
+        ValueShape innerOutput{};
+        auto inner = specialize(fieldPath.path,
+                                innerShape(input, ValueShape::kObject,
+                                           input.getField(fieldPath.fieldName)),
+                                innerOutput);
+        output = input;
+        if (inner.is<IdPath>()) {
+            // Writing back the field's own value does not change the input.
+            return inner;
+        }
+
+        if (input.mayBe(ValueShape::kObject)) {
+            output.setField(fieldPath.fieldName, innerOutput);
+        }
+        if (!input.isOnly(ValueShape::kObject)) {
+            // Other values are replaced by an object holding the field alone, unless the inner
+            // path yields Nothing.
+            if (!innerOutput.mayBe(ValueShape::kNothing)) {
+                output.restrict(ValueShape::kObject);
+            }
+            ValueShape created{ValueShape::kObject};
+            created.setOtherFields(ValueShape{ValueShape::kNothing});
+            created.setField(fieldPath.fieldName, std::move(innerOutput));
+            output.unite(created);
+        }
+        return Path::make<FieldPath>(fieldPath.fieldName, std::move(inner));
+    }
+
+    Path operator()(const Path&,
+                    const GetPath& getPath,
+                    const ValueShape& input,
+                    ValueShape& output) {
+        auto inner = specialize(
+            getPath.path,
+            innerShape(input, ValueShape::kObject, input.getField(getPath.fieldName)),
+            output);
+        if (!input.mayBe(ValueShape::kObject)) {
+            // The inner path always runs over Nothing.
+            return ast::compose(ast::constPath(ast::nothing()), std::move(inner));
+        }
+        return Path::make<GetPath>(getPath.fieldName, std::move(inner));
+    }
+
+    Path operator()(const Path&,
+                    const AtPath& atPath,
+                    const ValueShape& input,
+                    ValueShape& output) {
+        // An index past the end of an array reaches Nothing as well.
+        auto innerInput = innerShape(input, ValueShape::kArray, input.getElements());
+        innerInput.unite(ValueShape{ValueShape::kNothing});
+        auto inner = specialize(atPath.path, innerInput, output);
+        if (!input.mayBe(ValueShape::kArray)) {
+            return ast::compose(ast::constPath(ast::nothing()), std::move(inner));
+        }
+        return Path::make<AtPath>(atPath.index, std::move(inner));
+    }
+
+    Path operator()(const Path&,
+                    const TraversePath& traversePath,
+                    const ValueShape& input,
+                    ValueShape& output) {
+        if (!input.mayBe(ValueShape::kArray)) {
+            // Only the inner path runs, the traversal of arrays is never taken.
+            return specialize(traversePath.path, input, output);
+        }
+
+        // The inner path runs over the input if it is not an array and over the elements of
+        // arrays which are not arrays themselves, at any level of nesting.
+        ValueShape innerInput{0};
+        const ValueShape* level = &input;
+        for (int depth = 0;; ++depth) {
+            auto values = *level;
+            values.restrict(~ValueShape::kArray);
+            innerInput.unite(values);
+            if (!level->mayBe(ValueShape::kArray)) {
+                break;
+            }
+            if (depth == kMaxTraverseDepth) {
+                innerInput = ValueShape{};
+                break;
+            }
+            level = &level->getElements();
+        }
+
+        ValueShape innerOutput{};
+        auto inner = specialize(traversePath.path, innerInput, innerOutput);
+
+        output = ValueShape{0};
+        if (!input.isOnly(ValueShape::kArray)) {
+            output = innerOutput;
+        }
+        // Nothing results are left out of the arrays, nested arrays stay arrays.
+        auto elements = innerOutput;
+        elements.restrict(~ValueShape::kNothing);
+        if (input.getElements().mayBe(ValueShape::kArray)) {
+            elements.unite(ValueShape{ValueShape::kArray});
+        }
+        ValueShape arrays{ValueShape::kArray};
+        arrays.setElements(std::move(elements));
+        output.unite(arrays);
+        return Path::make<TraversePath>(std::move(inner));
+    }
+
+    Path operator()(const Path&,
+                    const CompositionPath& composition,
+                    const ValueShape& input,
+                    ValueShape& output) {
+        ValueShape middle{};
+        auto left = specialize(composition.left, input, middle);
+        auto right = specialize(composition.right, middle, output);
+        if (left.is<IdPath>()) {
+            return right;
+        }
+        if (right.is<IdPath>()) {
+            return left;
+        }
+        return Path::make<CompositionPath>(std::move(left), std::move(right));
+    }
+
+private:
+    /**
+     * Obj or Arr, which passes on values of 'kind' and turns all others into Nothing.
+     */
+    Path guard(const Path& path, uint8_t kind, const ValueShape& input, ValueShape& output) {
+        if (input.isOnly(kind | ValueShape::kNothing)) {
+            output = input;
+            return ast::id();
+        }
+        output = ValueShape{ValueShape::kNothing};
+        if (!input.mayBe(kind)) {
+            return ast::constPath(ast::nothing());
+        }
+        auto passed = input;
+        passed.restrict(kind);
+        output.unite(passed);
+        return path;
+    }
+};
+
+/**
+ * Evaluates the expressions of Const and Default steps. Subtrees without anything to fold are
+ * returned as they are instead of being rebuilt.
+ */
+class ConstantFolder {
+public:
+    template <typename T>
+    Path operator()(const Path& path, const T&) {
+        return path;
+    }
+
+    Path operator()(const Path& path, const ConstPath& constPath) {
+        if (constPath.expr.is<ConstantValue>()) {
+            return path;
+        }
+        ++_foldedCount;
+        return ast::constPath(ast::expr(evaluate(constPath.expr)));
+    }
+
+    Path operator()(const Path& path, const DefaultPath& defaultPath) {
+        if (defaultPath.expr.is<ConstantValue>()) {
+            return path;
+        }
+        ++_foldedCount;
+        return ast::defaultPath(ast::expr(evaluate(defaultPath.expr)));
+    }
+
+    Path operator()(const Path& path, const FieldPath& fieldPath) {
+        const auto foldedCount = _foldedCount;
+        auto inner = fieldPath.path.visit(*this);
+        if (foldedCount == _foldedCount) {
+            return path;
+        }
+        return Path::make<FieldPath>(fieldPath.fieldName, std::move(inner));
+    }
+
+    Path operator()(const Path& path, const GetPath& getPath) {
+        const auto foldedCount = _foldedCount;
+        auto inner = getPath.path.visit(*this);
+        if (foldedCount == _foldedCount) {
+            return path;
+        }
+        return Path::make<GetPath>(getPath.fieldName, std::move(inner));
+    }
+
+    Path operator()(const Path& path, const AtPath& atPath) {
+        const auto foldedCount = _foldedCount;
+        auto inner = atPath.path.visit(*this);
+        if (foldedCount == _foldedCount) {
+            return path;
+        }
+        return Path::make<AtPath>(atPath.index, std::move(inner));
+    }
+
+    Path operator()(const Path& path, const TraversePath& traversePath) {
+        const auto foldedCount = _foldedCount;
+        auto inner = traversePath.path.visit(*this);
+        if (foldedCount == _foldedCount) {
+            return path;
+        }
+        return Path::make<TraversePath>(std::move(inner));
+    }
+
+    Path operator()(const Path& path, const CompositionPath& composition) {
+        const auto foldedCount = _foldedCount;
+        auto left = composition.left.visit(*this);
+        auto right = composition.right.visit(*this);
+        if (foldedCount == _foldedCount) {
+            return path;
+        }
+        return Path::make<CompositionPath>(std::move(left), std::move(right));
+    }
+
+    size_t getFoldedCount() const {
+        return _foldedCount;
+    }
+
+private:
+    size_t _foldedCount{0};
+};
+}  // namespace
+
+Path foldConstants(const Path& path, size_t& foldedCount) {
+    ConstantFolder folder{};
+    auto result = path.visit(folder);
+    foldedCount += folder.getFoldedCount();
+    return result;
+}
+
+Path optimize(const Path& path) {
+    PathOptimizer optimizer{};
+    return path.visit(optimizer);
+}
+
+Path specialize(const Path& path, const ValueShape& input, ValueShape& output) {
+    ShapeSpecializer specializer{};
+    return specializer.specialize(path, input, output);
+}
+
+ValueShape inferShape(const Path& path, const ValueShape& input) {
+    ValueShape output{};
+    specialize(path, input, output);
+    return output;
+}
+}  // namespace mqlpath
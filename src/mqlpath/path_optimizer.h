@@ -0,0 +1,45 @@
+#pragma once
+
+#include "mqlpath/ast.h"
+#include "mqlpath/value_shape.h"
+#include <cstddef>
+
+namespace mqlpath {
+/**
+ * Rewrites the path into an equivalent one which is cheaper to evaluate:
+ * - composition chains are flattened and Id steps are removed;
+ * - consecutive Drops are merged and consecutive Keeps are intersected;
+ * - Obj and Arr guards whose outcome is already known are removed or folded to Const Nothing;
+ * - steps before a Const are dropped as their result is discarded;
+ * - steps following a Get or At are moved into its inner path, so that chains of Gets become
+ *   nested Gets.
+ */
+Path optimize(const Path& path);
+
+/**
+ * Replaces the expressions of Const and Default steps by the values they evaluate to. These
+ * expressions never depend on the input, so evaluating them once up front spares rebuilding the
+ * same value on every visit, e.g. for each element of a Traverse. Adds the number of folded
+ * expressions to 'foldedCount'.
+ */
+Path foldConstants(const Path& path, size_t& foldedCount);
+
+/**
+ * Rewrites the path into one which is equivalent for inputs of the given shape, inferring the
+ * shapes of the values between its steps from it:
+ * - Default is removed where its input is never Nothing and becomes Const where it always is;
+ * - Obj and Arr guards become Id or Const Nothing where their outcome is known;
+ * - Drop and Keep are removed where they would not remove any field;
+ * - Traverse becomes its inner path where its input is never an array;
+ * - Get and At whose input is never an object or array are replaced by Const Nothing.
+ * Sets 'output' to the shape of the results. The shapes of fields are followed through Field,
+ * Get, At and Traverse, so e.g. the Default in "Field a (Const 1) * Get a (Default 2)" is removed
+ * even for an input of any shape.
+ */
+Path specialize(const Path& path, const ValueShape& input, ValueShape& output);
+
+/**
+ * The shape of the results of the path over inputs of the given shape, see specialize().
+ */
+ValueShape inferShape(const Path& path, const ValueShape& input);
+}  // namespace mqlpath
@@ -0,0 +1,209 @@
+#include "mqlpath/ast_eval.h"
+#include "mqlpath/ast_make.h"
+#include "mqlpath/path_optimizer.h"
+#include "mqlpath/random_generator.h"
+#include <catch2/catch_message.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <sstream>
+
+namespace mqlpath {
+namespace {
+std::string toString(const Path& path) {
+    std::ostringstream os;
+    os << path;
+    return os.str();
+}
+
+std::string toString(const ValueShape& shape) {
+    std::ostringstream os;
+    os << shape;
+    return os.str();
+}
+
+std::string specialized(const Path& path, const ValueShape& input) {
+    ValueShape output{};
+    return toString(specialize(path, input, output));
+}
+
+/**
+ * Whether the value is one of those the shape describes.
+ */
+bool isOfShape(const Value& value, const ValueShape& shape) {
+    if (!shape.mayBe(ValueShape::of(value).getKinds())) {
+        return false;
+    }
+    if (auto array = value.cast<ArrayValue>(); array != nullptr) {
+        return std::all_of(array->array.begin(), array->array.end(), [&](const Value& element) {
+            return isOfShape(element, shape.getElements());
+        });
+    }
+    if (auto object = value.cast<ObjectValue>(); object != nullptr) {
+        const auto& names = object->object.getNames();
+        const auto& values = object->object.getValues();
+        for (size_t position = 0; position < names.size(); ++position) {
+            if (!isOfShape(values[position], shape.getField(names[position]))) {
+                return false;
+            }
+        }
+        // Fields which are missing are Nothing.
+        return std::all_of(
+            shape.getFieldNames().begin(), shape.getFieldNames().end(), [&](const auto& name) {
+                return !isNothing(object->object.getValue(name)) ||
+                    shape.getField(name).mayBe(ValueShape::kNothing);
+            });
+    }
+    return true;
+}
+}  // namespace
+
+TEST_CASE("optimize removes Id and flattens compositions", "[optimizer]") {
+    auto path = ast::compose(ast::compose(ast::id(), ast::field("a", ast::constPath(1))),
+                             ast::compose(ast::id(), ast::field("b", ast::id())));
+    REQUIRE(toString(optimize(path)) == "(Field a (Const 1))");
+    REQUIRE(toString(optimize(ast::compose(ast::id(), ast::id()))) == "Id");
+}
+
+TEST_CASE("optimize merges Drops and intersects Keeps", "[optimizer]") {
+    auto drops = ast::compose(ast::compose(ast::drop({"a", "b"}), ast::drop({"b", "c"})),
+                              ast::drop({"d"}));
+    REQUIRE(toString(optimize(drops)) == "(Drop a, b, c, d)");
+
+    auto keeps = ast::compose(ast::keep({"a", "b", "c"}),
+                              ast::compose(ast::id(), ast::keep({"c", "a"})));
+    REQUIRE(toString(optimize(keeps)) == "(Keep a, c)");
+}
+
+TEST_CASE("optimize removes checked guards", "[optimizer]") {
+    auto path = ast::compose(ast::compose(ast::obj(), ast::drop({"a"})), ast::obj());
+    REQUIRE(toString(optimize(path)) == "(Obj * (Drop a))");
+
+    REQUIRE(toString(optimize(ast::compose(ast::arr(), ast::obj()))) == "(Const Nothing)");
+    REQUIRE(toString(optimize(ast::compose(ast::constPath(5), ast::defaultPath(1)))) ==
+            "(Const 5)");
+}
+
+TEST_CASE("optimize moves following steps into Get", "[optimizer]") {
+    auto path = ast::compose(ast::compose(ast::get("a", ast::id()), ast::get("b", ast::id())),
+                             ast::at(1, ast::id()));
+    REQUIRE(toString(optimize(path)) == "(Get a (Get b (At 1 Id)))");
+}
+
+TEST_CASE("foldConstants evaluates Const and Default expressions", "[optimizer]") {
+    auto constant =
+        ast::evalPath(ast::get("a", ast::id()), ast::value(Object{{{"a", ast::value(3)}}}));
+    auto path = ast::compose(
+        ast::traverse(ast::constPath(constant)),
+        ast::compose(ast::defaultPath(constant), ast::field("b", ast::constPath(1))));
+
+    size_t foldedCount = 0;
+    auto folded = foldConstants(path, foldedCount);
+    REQUIRE(foldedCount == 2);
+    REQUIRE(toString(folded) == "((Traverse (Const 3)) * ((Default 3) * (Field b (Const 1))))");
+
+    foldedCount = 0;
+    auto unchanged = foldConstants(folded, foldedCount);
+    REQUIRE(foldedCount == 0);
+    REQUIRE(unchanged == folded);
+}
+
+TEST_CASE("optimized paths evaluate as the original ones", "[optimizer]") {
+    RandomGenerator generator{20230611};
+    for (int i = 0; i < 2000; ++i) {
+        auto path = generator.path(4);
+        auto optimized = optimize(path);
+        INFO(path);
+        INFO(optimized);
+
+        for (int j = 0; j < 5; ++j) {
+            auto document = generator.value(3);
+            INFO(document);
+            REQUIRE(evaluate(ast::evalPath(path, document)) ==
+                    evaluate(ast::evalPath(optimized, document)));
+        }
+    }
+}
+
+TEST_CASE("specialize removes Default where the input is known", "[optimizer]") {
+    ValueShape numbers{ValueShape::kInt32 | ValueShape::kDouble};
+    REQUIRE(specialized(ast::defaultPath(1), numbers) == "Id");
+    REQUIRE(specialized(ast::defaultPath(1), ValueShape{ValueShape::kNothing}) == "(Const 1)");
+    REQUIRE(specialized(ast::defaultPath(1), ValueShape{}) == "(Default 1)");
+
+    // The field was just set, whatever the input.
+    auto path = ast::compose(ast::field("a", ast::constPath(1)),
+                             ast::get("a", ast::defaultPath(2)));
+    ValueShape output{};
+    REQUIRE(toString(specialize(path, ValueShape{}, output)) ==
+            "((Field a (Const 1)) * (Get a Id))");
+    REQUIRE(toString(output) == "int32");
+}
+
+TEST_CASE("specialize folds guards", "[optimizer]") {
+    auto document = ValueShape::of(ast::value(Object{{
+        {"a", ast::value(Object{{{"b", ast::value(1)}}})},
+        {"c", ast::value(std::vector<int32_t>{1, 2})},
+    }}));
+    REQUIRE(specialized(ast::get("a", ast::obj()), document) == "(Get a Id)");
+    REQUIRE(specialized(ast::get("a", ast::arr()), document) == "(Get a (Const Nothing))");
+    REQUIRE(specialized(ast::get("c", ast::arr()), document) == "(Get c Id)");
+    REQUIRE(specialized(ast::get("d", ast::obj()), document) == "(Get d Id)");
+    REQUIRE(specialized(ast::obj(), ValueShape{}) == "Obj");
+
+    // Nothing is dropped or left out.
+    REQUIRE(specialized(ast::drop({"d"}), document) == "Id");
+    REQUIRE(specialized(ast::drop({"a", "d"}), document) == "(Drop a, d)");
+    REQUIRE(specialized(ast::keep({"a", "c"}), document) == "Id");
+    REQUIRE(specialized(ast::keep({"a"}), document) == "(Keep a)");
+    REQUIRE(specialized(ast::get("c", ast::drop({"a"})), document) == "(Get c Id)");
+}
+
+TEST_CASE("specialize skips the traversal of values which are not arrays", "[optimizer]") {
+    auto document = ValueShape::of(ast::value(Object{{
+        {"a", ast::value(Object{{{"b", ast::value(1)}}})},
+        {"c", Value::make<ArrayValue>(std::vector<Value>{ast::value(Object{}), ast::nothing()})},
+    }}));
+    REQUIRE(specialized(ast::get("a", ast::traverse(ast::get("b", ast::id()))), document) ==
+            "(Get a (Get b Id))");
+    REQUIRE(specialized(ast::get("c", ast::traverse(ast::get("b", ast::defaultPath(1)))),
+                        document) == "(Get c (Traverse (Get b (Const 1))))");
+    REQUIRE(specialized(ast::get("c", ast::traverse(ast::obj())), document) ==
+            "(Get c (Traverse Id))");
+    REQUIRE(specialized(ast::at(0, ast::defaultPath(1)), document) ==
+            "((Const Nothing) * (Const 1))");
+
+    ValueShape output{};
+    specialize(ast::get("c", ast::traverse(ast::get("b", ast::defaultPath(1)))), document, output);
+    REQUIRE(toString(output) == "array[int32]");
+}
+
+TEST_CASE("specialized paths evaluate as the original ones over inputs of the shape",
+          "[optimizer]") {
+    RandomGenerator generator{20241019};
+    std::vector<Value> documents{};
+    for (int i = 0; i < 2000; ++i) {
+        auto path = generator.path(4);
+        INFO(path);
+        documents.clear();
+        ValueShape shape{0};
+        for (int j = 0; j < 3; ++j) {
+            documents.emplace_back(generator.value(3));
+            shape.unite(ValueShape::of(documents.back()));
+        }
+        INFO(shape);
+
+        for (const auto& input : {ValueShape{}, shape}) {
+            ValueShape output{};
+            auto specializedPath = specialize(path, input, output);
+            INFO(specializedPath);
+            INFO(output);
+            for (const auto& document : documents) {
+                INFO(document);
+                auto result = evaluate(path, document);
+                REQUIRE(evaluate(specializedPath, document) == result);
+                REQUIRE(isOfShape(result, output));
+            }
+        }
+    }
+}
+}  // namespace mqlpath
@@ -0,0 +1,323 @@
+#include "mqlpath/path_program.h"
+#include "mqlpath/ast_eval.h"
+#include "mqlpath/stream_utils.h"
+#include <utility>
+
+namespace mqlpath {
+class PathCompiler {
+public:
+    explicit PathCompiler(PathProgram& program) : _program(program) {}
+
+    void operator()(const Path&, const IdPath&) {}
+
+    void operator()(const Path&, const ConstPath& path) {
+        emit(OpCode::Const, addConstant(path.expr));
+    }
+
+    void operator()(const Path&, const DefaultPath& path) {
+        emit(OpCode::Default, addConstant(path.expr));
+    }
+
+    void operator()(const Path&, const LambdaPath&) {
+        emit(OpCode::Lambda);
+    }
+
+    void operator()(const Path&, const DropPath& path) {
+        emit(OpCode::Drop, addFieldList(path.fieldNames));
+    }
+
+    void operator()(const Path&, const KeepPath& path) {
+        emit(OpCode::Keep, addFieldList(path.fieldNames));
+    }
+
+    void operator()(const Path&, const ObjPath&) {
+        emit(OpCode::Obj);
+    }
+
+    void operator()(const Path&, const ArrPath&) {
+        emit(OpCode::Arr);
+    }
+
+    void operator()(const Path&, const FieldPath& path) {
+        emit(OpCode::FieldEnter, 0, path.fieldName);
+        path.path.visit(*this);
+        emit(OpCode::FieldExit, 0, path.fieldName);
+    }
+
+    void operator()(const Path&, const GetPath& path) {
+        emit(OpCode::Get, 0, path.fieldName);
+        path.path.visit(*this);
+    }
+
+    void operator()(const Path&, const AtPath& path) {
+        emit(OpCode::At, path.index);
+        path.path.visit(*this);
+    }
+
+    void operator()(const Path&, const TraversePath& path) {
+        auto enter = emit(OpCode::TraverseEnter);
+        path.path.visit(*this);
+        auto exit = emit(OpCode::TraverseExit, enter);
+        _program._code[enter].operand = exit;
+    }
+
+    void operator()(const Path&, const CompositionPath& path) {
+        path.left.visit(*this);
+        path.right.visit(*this);
+    }
+
+private:
+    int32_t emit(OpCode opCode, int32_t operand = 0, FieldName fieldName = {}) {
+        _program._code.push_back(Instruction{opCode, operand, fieldName});
+        return static_cast<int32_t>(_program._code.size() - 1);
+    }
+
+    int32_t addConstant(const Expression& expr) {
+        _program._constants.push_back(evaluate(expr));
+        return static_cast<int32_t>(_program._constants.size() - 1);
+    }
+
+    int32_t addFieldList(const std::vector<FieldName>& fieldNames) {
+        _program._fieldLists.push_back(fieldNames);
+        return static_cast<int32_t>(_program._fieldLists.size() - 1);
+    }
+
+    PathProgram& _program;
+};
+
+namespace {
+/**
+ * Moves to the next element of the innermost traversed array. Nested arrays push a new frame of
+ * the same Traverse. Returns the position to continue from and sets 'value' to either the next
+ * element or the result of the whole Traverse.
+ */
+size_t nextElement(const std::vector<Instruction>& code,
+                   PathProgram::Frames& frames,
+                   Value& value) {
+    while (true) {
+        auto& frame = frames.back();
+        auto& array = frame.saved.cast<ArrayValue>()->array;
+        if (frame.index < array.size()) {
+            auto element = std::move(array[frame.index++]);
+            if (isArray(element)) {
+                auto pc = frame.pc;
+                frames.push_back(
+                    PathFrame{PathFrame::Kind::TraverseArray, pc, std::move(element)});
+                continue;
+            }
+            value = std::move(element);
+            return frame.pc + 1;
+        }
+
+        auto result = Value::make<ArrayValue>(std::move(frame.values));
+        auto pc = frame.pc;
+        frames.pop_back();
+        if (!frames.empty() && frames.back().kind == PathFrame::Kind::TraverseArray &&
+            frames.back().pc == pc) {
+            frames.back().values.emplace_back(std::move(result));
+            continue;
+        }
+
+        value = std::move(result);
+        return code[pc].operand + 1;
+    }
+}
+}  // namespace
+
+Value PathProgram::run(Value input) const {
+    Frames frames{};
+    return run(std::move(input), frames);
+}
+
+Value PathProgram::run(Value value, Frames& frames) const {
+    size_t pc = 0;
+    while (pc < _code.size()) {
+        const auto& instruction = _code[pc];
+        switch (instruction.opCode) {
+            case OpCode::Const:
+                value = _constants[instruction.operand];
+                break;
+
+            case OpCode::Default:
+                if (isNothing(value)) {
+                    value = _constants[instruction.operand];
+                }
+                break;
+
+            case OpCode::Lambda:
+                value = Value::make<NothingValue>();
+                break;
+
+            case OpCode::Drop:
+                if (isObject(value)) {
+                    value.cast<ObjectValue>()->object.dropFields(_fieldLists[instruction.operand]);
+                }
+                break;
+
+            case OpCode::Keep:
+                if (isObject(value)) {
+                    value.cast<ObjectValue>()->object.keepFields(_fieldLists[instruction.operand]);
+                }
+                break;
+
+            case OpCode::Obj:
+                if (!isObject(value)) {
+                    value = Value::make<NothingValue>();
+                }
+                break;
+
+            case OpCode::Arr:
+                if (!isArray(value)) {
+                    value = Value::make<NothingValue>();
+                }
+                break;
+
+            case OpCode::Get:
+                if (isObject(value)) {
+                    value = std::as_const(value).cast<ObjectValue>()->object.getValue(
+                        instruction.fieldName);
+                } else {
+                    value = Value::make<NothingValue>();
+                }
+                break;
+
+            case OpCode::At:
+                if (isArray(value)) {
+                    const auto& array = std::as_const(value).cast<ArrayValue>()->array;
+                    if (array.size() > static_cast<size_t>(instruction.operand)) {
+                        value = Value{array[instruction.operand]};
+                        break;
+                    }
+                }
+                value = Value::make<NothingValue>();
+                break;
+
+            case OpCode::FieldEnter: {
+                // The field is moved out of the object, which is updated in place at FieldExit.
+                size_t position = Object::npos;
+                auto innerValue = isObject(value)
+                    ? value.cast<ObjectValue>()->object.releaseValue(instruction.fieldName,
+                                                                     position)
+                    : Value::make<NothingValue>();
+                frames.push_back(
+                    PathFrame{PathFrame::Kind::Field, pc, std::move(value), position});
+                value = std::move(innerValue);
+                break;
+            }
+
+            case OpCode::FieldExit: {
+                auto saved = std::move(frames.back().saved);
+                const size_t position = frames.back().index;
+                frames.pop_back();
+                if (isObject(saved)) {
+                    saved.cast<ObjectValue>()->object.restoreValue(
+                        instruction.fieldName, position, std::move(value));
+                    value = std::move(saved);
+                } else if (!isNothing(value)) {
+                    Object object{};
+                    object.setValue(instruction.fieldName, std::move(value));
+                    value = Value::make<ObjectValue>(std::move(object));
+                } else {
+                    value = std::move(saved);
+                }
+                break;
+            }
+
+            case OpCode::TraverseEnter:
+                if (!isArray(value)) {
+                    frames.push_back(PathFrame{PathFrame::Kind::TraverseValue, pc});
+                    break;
+                }
+                frames.push_back(
+                    PathFrame{PathFrame::Kind::TraverseArray, pc, std::move(value)});
+                pc = nextElement(_code, frames, value);
+                continue;
+
+            case OpCode::TraverseExit:
+                if (frames.back().kind == PathFrame::Kind::TraverseValue) {
+                    frames.pop_back();
+                    break;
+                }
+                if (!isNothing(value)) {
+                    frames.back().values.emplace_back(std::move(value));
+                }
+                pc = nextElement(_code, frames, value);
+                continue;
+        }
+        ++pc;
+    }
+    return value;
+}
+
+PathProgram compile(const Path& path) {
+    PathProgram program{};
+    PathCompiler compiler{program};
+    path.visit(compiler);
+    return program;
+}
+
+namespace {
+const char* toString(OpCode opCode) {
+    switch (opCode) {
+        case OpCode::Const:
+            return "Const";
+        case OpCode::Default:
+            return "Default";
+        case OpCode::Lambda:
+            return "Lambda";
+        case OpCode::Drop:
+            return "Drop";
+        case OpCode::Keep:
+            return "Keep";
+        case OpCode::Obj:
+            return "Obj";
+        case OpCode::Arr:
+            return "Arr";
+        case OpCode::Get:
+            return "Get";
+        case OpCode::At:
+            return "At";
+        case OpCode::FieldEnter:
+            return "FieldEnter";
+        case OpCode::FieldExit:
+            return "FieldExit";
+        case OpCode::TraverseEnter:
+            return "TraverseEnter";
+        case OpCode::TraverseExit:
+            return "TraverseExit";
+    }
+    return "Unknown";
+}
+}  // namespace
+
+std::ostream& operator<<(std::ostream& os, const PathProgram& program) {
+    for (size_t pc = 0; pc < program._code.size(); ++pc) {
+        const auto& instruction = program._code[pc];
+        os << pc << ": " << toString(instruction.opCode);
+        switch (instruction.opCode) {
+            case OpCode::Const:
+            case OpCode::Default:
+                os << " " << program._constants[instruction.operand];
+                break;
+            case OpCode::Drop:
+            case OpCode::Keep:
+                os << " " << program._fieldLists[instruction.operand];
+                break;
+            case OpCode::Get:
+            case OpCode::FieldEnter:
+            case OpCode::FieldExit:
+                os << " " << instruction.fieldName;
+                break;
+            case OpCode::At:
+            case OpCode::TraverseEnter:
+            case OpCode::TraverseExit:
+                os << " " << instruction.operand;
+                break;
+            default:
+                break;
+        }
+        os << std::endl;
+    }
+    return os;
+}
+}  // namespace mqlpath
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "mqlpath/ast.h"
+#include "mqlpath/field_name.h"
+#include "mqlpath/value.h"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace mqlpath {
+enum class OpCode : uint8_t {
+    Const,
+    Default,
+    Lambda,
+    Drop,
+    Keep,
+    Obj,
+    Arr,
+    Get,
+    At,
+    FieldEnter,
+    FieldExit,
+    TraverseEnter,
+    TraverseExit,
+};
+
+/**
+ * A single step of a PathProgram. Field names and array indices are stored inline, the operand
+ * is either the index, a position in one of the program's pools or a jump target.
+ */
+struct Instruction {
+    OpCode opCode;
+    int32_t operand;
+    FieldName fieldName;
+};
+
+/**
+ * Saved state of an enclosing Field or Traverse while the code of its inner path runs.
+ */
+struct PathFrame {
+    enum class Kind { Field, TraverseValue, TraverseArray };
+
+    Kind kind;
+    // Position of the Enter instruction.
+    size_t pc;
+    // The object for Field, the array being traversed for TraverseArray.
+    Value saved{};
+    // The position of the field in the object for Field, of the next element for TraverseArray.
+    size_t index{0};
+    Array values{};
+};
+
+/**
+ * A Path lowered into a flat instruction array. Get, At and composition become straight-line
+ * code, while Field and Traverse are compiled as Enter/Exit pairs around the code of their inner
+ * path, so the interpreter runs in a single loop with an explicit frame stack instead of
+ * recursing through the Path tree. Expressions never depend on the input, so the ones of Const and
+ * Default are evaluated during compilation and the program hands out shared copies of the results.
+ */
+class PathProgram {
+public:
+    using Frames = std::vector<PathFrame>;
+
+    Value run(Value input) const;
+
+    /**
+     * Runs the program using 'frames' as the frame stack. Reusing the same stack for consecutive
+     * runs spares allocating it for every document. The stack is empty again when run returns.
+     */
+    Value run(Value input, Frames& frames) const;
+
+    const std::vector<Instruction>& getCode() const {
+        return _code;
+    }
+
+private:
+    friend class PathCompiler;
+    friend std::ostream& operator<<(std::ostream& os, const PathProgram& program);
+
+    std::vector<Instruction> _code;
+    // Values of the Const and Default expressions, evaluated once at compile time.
+    std::vector<Value> _constants;
+    std::vector<std::vector<FieldName>> _fieldLists;
+};
+
+PathProgram compile(const Path& path);
+
+std::ostream& operator<<(std::ostream& os, const PathProgram& program);
+}  // namespace mqlpath
@@ -0,0 +1,57 @@
+#include "mqlpath/ast_eval.h"
+#include "mqlpath/ast_make.h"
+#include "mqlpath/path_optimizer.h"
+#include "mqlpath/path_program.h"
+#include "mqlpath/value.h"
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+namespace mqlpath {
+TEST_CASE("PathEval vs PathProgram", "[program][benchmark]") {
+    Array items{};
+    for (int32_t i = 0; i < 100; ++i) {
+        items.emplace_back(ast::value(Object{{
+            {"id", ast::value(i)},
+            {"name", ast::value("item " + std::to_string(i))},
+            {"tags", ast::value(std::vector<std::string>{"x", "y"})},
+        }}));
+    }
+    auto document = ast::value(Object{{
+        {"a", ast::value(Object{{{"b", ast::value(Object{{{"c", ast::value(1)}}})}}})},
+        {"items", Value::make<ArrayValue>(std::move(items))},
+    }});
+
+    std::vector<std::pair<std::string, Path>> paths{};
+    paths.emplace_back("Get a.b.c", ast::get("a", ast::get("b", ast::get("c", ast::id()))));
+    paths.emplace_back("Traverse Get",
+                       ast::get("items", ast::traverse(ast::get("id", ast::id()))));
+    paths.emplace_back("Traverse Field",
+                       ast::field("items", ast::traverse(ast::field("id", ast::constPath(0)))));
+    paths.emplace_back(
+        "Traverse Const EvalPath",
+        ast::get("items",
+                 ast::traverse(ast::constPath(ast::evalPath(
+                     ast::get("a", ast::id()),
+                     ast::value(Object{{{"a", ast::value(std::vector<int32_t>{1, 2})}}}))))));
+
+    for (const auto& [name, path] : paths) {
+        auto expr = ast::evalPath(path, document);
+        BENCHMARK("PathEval " + name) {
+            return evaluate(expr);
+        };
+
+        // As PreparedPath does, the constants are folded once ahead of the evaluations.
+        size_t foldedCount = 0;
+        auto folded = foldConstants(path, foldedCount);
+        BENCHMARK("PathEval folded " + name) {
+            return evaluate(folded, document);
+        };
+
+        auto program = compile(path);
+        BENCHMARK("PathProgram " + name) {
+            return program.run(document);
+        };
+    }
+}
+}  // namespace mqlpath
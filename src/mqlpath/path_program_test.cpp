@@ -0,0 +1,77 @@
+#include "mqlpath/ast_eval.h"
+#include "mqlpath/ast_make.h"
+#include "mqlpath/path_program.h"
+#include "mqlpath/value.h"
+#include <catch2/catch_message.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace mqlpath {
+namespace {
+void requireSameAsPathEval(const Path& path, const Value& input) {
+    auto program = compile(path);
+    INFO(path);
+    INFO(program);
+    auto expected = evaluate(ast::evalPath(path, input));
+    REQUIRE(expected == program.run(input));
+}
+
+Value array(std::vector<Value> values) {
+    return Value::make<ArrayValue>(std::move(values));
+}
+}  // namespace
+
+TEST_CASE("program layout", "[program]") {
+    auto program = compile(ast::field("a", ast::traverse(ast::get("b", ast::id()))));
+    const auto& code = program.getCode();
+
+    REQUIRE(code.size() == 5);
+    REQUIRE(code[0].opCode == OpCode::FieldEnter);
+    REQUIRE(code[0].fieldName == "a");
+    REQUIRE(code[1].opCode == OpCode::TraverseEnter);
+    REQUIRE(code[1].operand == 3);
+    REQUIRE(code[2].opCode == OpCode::Get);
+    REQUIRE(code[3].opCode == OpCode::TraverseExit);
+    REQUIRE(code[3].operand == 1);
+    REQUIRE(code[4].opCode == OpCode::FieldExit);
+}
+
+TEST_CASE("program Id is empty", "[program]") {
+    auto program = compile(ast::compose(ast::id(), ast::id()));
+    REQUIRE(program.getCode().empty());
+    REQUIRE(ast::value(5) == program.run(ast::value(5)));
+}
+
+TEST_CASE("program Traverse over nested arrays", "[program]") {
+    auto input = array({ast::value(1),
+                        array({ast::value(2), array({ast::value(3)}), array({})}),
+                        ast::value(Object{{{"a", ast::value(4)}}})});
+
+    requireSameAsPathEval(ast::traverse(ast::constPath(7)), input);
+    requireSameAsPathEval(ast::traverse(ast::get("a", ast::id())), input);
+    requireSameAsPathEval(ast::traverse(ast::field("b", ast::constPath(1))), input);
+    requireSameAsPathEval(ast::traverse(ast::traverse(ast::defaultPath(0))), input);
+}
+
+TEST_CASE("program Traverse inside Field inside Traverse", "[program]") {
+    Object inner{{{"b", array({ast::value(1), ast::value(2)})}}};
+    auto input = array({ast::value(inner), ast::value(3), array({ast::value(inner)})});
+    auto path = ast::traverse(ast::field(
+        "b", ast::traverse(ast::compose(ast::arr(), ast::constPath(ast::nothing())))));
+
+    requireSameAsPathEval(path, input);
+    requireSameAsPathEval(ast::traverse(ast::field("b", ast::traverse(ast::constPath(9)))), input);
+}
+
+TEST_CASE("program Field, Drop and Keep", "[program]") {
+    Object object{{{"a", ast::value(1)}, {"b", ast::value(2)}, {"c", ast::value(3)}}};
+    auto input = ast::value(object);
+
+    requireSameAsPathEval(ast::compose(ast::drop({"a"}), ast::field("d", ast::constPath(4))),
+                          input);
+    requireSameAsPathEval(ast::compose(ast::keep({"a", "c"}), ast::field("a", ast::lambda(1))),
+                          input);
+    requireSameAsPathEval(ast::field("a", ast::field("x", ast::constPath(5))), input);
+    requireSameAsPathEval(ast::field("a", ast::field("x", ast::constPath(5))), ast::nothing());
+    requireSameAsPathEval(ast::at(1, ast::obj()), array({ast::value(1), input}));
+}
+}  // namespace mqlpath
@@ -0,0 +1,193 @@
+#include "mqlpath/path_projection.h"
+#include "mqlpath/ast_eval.h"
+#include "mqlpath/path_optimizer.h"
+
+namespace mqlpath {
+namespace {
+// Input of the steps below a Get or At which reaches no value.
+const Value kNothing = Value::make<NothingValue>();
+
+/**
+ * Splits a path into the sequence of its steps. Get and At become steps of their own, with an Id
+ * inner path, and compositions are flattened.
+ */
+struct StepCollector {
+    void operator()(const Path&, const IdPath&) {}
+
+    void operator()(const Path&, const GetPath& path) {
+        steps.emplace_back(Path::make<GetPath>(path.fieldName, Path::make<IdPath>()));
+        path.path.visit(*this);
+    }
+
+    void operator()(const Path&, const AtPath& path) {
+        steps.emplace_back(Path::make<AtPath>(path.index, Path::make<IdPath>()));
+        path.path.visit(*this);
+    }
+
+    void operator()(const Path&, const CompositionPath& path) {
+        path.left.visit(*this);
+        path.right.visit(*this);
+    }
+
+    template <typename T>
+    void operator()(const Path& p, const T&) {
+        steps.emplace_back(p);
+    }
+
+    std::vector<Path> steps;
+};
+
+std::vector<Path> getSteps(const Path& path) {
+    StepCollector collector{};
+    path.visit(collector);
+    return std::move(collector.steps);
+}
+
+template <typename Key>
+size_t findChild(const std::vector<std::pair<Key, size_t>>& children, const Key& key) {
+    for (const auto& [childKey, child] : children) {
+        if (childKey == key) {
+            return child;
+        }
+    }
+    return static_cast<size_t>(-1);
+}
+}  // namespace
+
+struct PathProjection::Builder {
+    /**
+     * Adds the path 'index' below 'node', which it reaches after the steps before 'first'.
+     */
+    void insert(size_t node, const std::vector<Path>& steps, size_t first, size_t index) {
+        for (; first < steps.size(); ++first) {
+            const auto& step = steps[first];
+            if (auto get = step.cast<GetPath>(); get != nullptr) {
+                node = getChild(&Node::gets, node, get->fieldName);
+            } else if (auto at = step.cast<AtPath>(); at != nullptr) {
+                node = getChild(&Node::ats, node, at->index);
+            } else if (auto traverse = step.cast<TraversePath>();
+                       traverse != nullptr && first + 1 == steps.size()) {
+                // A Traverse collects the results of its inner path into an array. Steps after it
+                // apply to that array, so only a final Traverse can share its inner path.
+                if (nodes[node].traverse == npos) {
+                    const size_t inner = addNode();
+                    nodes[node].traverse = inner;
+                }
+                node = nodes[node].traverse;
+                nodes[node].traversed.push_back(index);
+                insert(node, getSteps(traverse->path), 0, index);
+                return;
+            } else {
+                Path rest = steps.back();
+                for (size_t position = steps.size() - 1; position > first; --position) {
+                    rest = Path::make<CompositionPath>(steps[position - 1], std::move(rest));
+                }
+                nodes[node].residuals.emplace_back(index, std::move(rest));
+                return;
+            }
+        }
+        nodes[node].outputs.push_back(index);
+    }
+
+    template <typename Key>
+    size_t getChild(std::vector<std::pair<Key, size_t>> Node::*children,
+                    size_t node,
+                    const Key& key) {
+        auto child = findChild(nodes[node].*children, key);
+        if (child == npos) {
+            child = addNode();
+            (nodes[node].*children).emplace_back(key, child);
+        }
+        return child;
+    }
+
+    size_t addNode() {
+        nodes.emplace_back();
+        return nodes.size() - 1;
+    }
+
+    std::vector<Node>& nodes;
+};
+
+PathProjection::PathProjection(const std::vector<Path>& paths) : _size(paths.size()) {
+    Builder builder{_nodes};
+    builder.addNode();
+    for (size_t index = 0; index < paths.size(); ++index) {
+        size_t foldedCount = 0;
+        builder.insert(0, getSteps(optimize(foldConstants(paths[index], foldedCount))), 0, index);
+    }
+}
+
+void PathProjection::evaluate(const Value& input, std::vector<Value>& outputs) const {
+    outputs.resize(_size);
+    evaluate(0, input, outputs);
+}
+
+std::vector<Value> PathProjection::evaluate(const Value& input) const {
+    std::vector<Value> outputs{};
+    evaluate(input, outputs);
+    return outputs;
+}
+
+void PathProjection::evaluate(size_t node,
+                              const Value& value,
+                              std::vector<Value>& outputs) const {
+    const auto& current = _nodes[node];
+    for (auto index : current.outputs) {
+        outputs[index] = value;
+    }
+    for (const auto& [index, path] : current.residuals) {
+        outputs[index] = evaluateBorrowed(path, value).copyOut();
+    }
+
+    if (!current.gets.empty()) {
+        const Object* object = isObject(value) ? &value.cast<ObjectValue>()->object : nullptr;
+        for (const auto& [fieldName, child] : current.gets) {
+            const Value* field = object != nullptr ? object->findValue(fieldName) : nullptr;
+            evaluate(child, field != nullptr ? *field : kNothing, outputs);
+        }
+    }
+
+    if (!current.ats.empty()) {
+        const Array* array = isArray(value) ? &value.cast<ArrayValue>()->array : nullptr;
+        for (const auto& [index, child] : current.ats) {
+            const bool found = array != nullptr && array->size() > static_cast<size_t>(index);
+            evaluate(child, found ? (*array)[index] : kNothing, outputs);
+        }
+    }
+
+    if (current.traverse != npos) {
+        evaluateTraverse(current.traverse, value, outputs);
+    }
+}
+
+void PathProjection::evaluateTraverse(size_t node,
+                                      const Value& value,
+                                      std::vector<Value>& outputs) const {
+    if (!isArray(value)) {
+        evaluate(node, value, outputs);
+        return;
+    }
+
+    // Every path below the node writes its output once per element, so the outputs serve as the
+    // scratch space for the results of an element before they are moved into the arrays.
+    const auto& paths = _nodes[node].traversed;
+    std::vector<Array> arrays(paths.size());
+    for (const auto& element : value.cast<ArrayValue>()->array) {
+        if (isArray(element)) {
+            evaluateTraverse(node, element, outputs);
+        } else {
+            evaluate(node, element, outputs);
+        }
+        for (size_t position = 0; position < paths.size(); ++position) {
+            auto& output = outputs[paths[position]];
+            if (!isNothing(output)) {
+                arrays[position].emplace_back(std::move(output));
+            }
+        }
+    }
+    for (size_t position = 0; position < paths.size(); ++position) {
+        outputs[paths[position]] = Value::make<ArrayValue>(std::move(arrays[position]));
+    }
+}
+}  // namespace mqlpath
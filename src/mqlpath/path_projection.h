@@ -0,0 +1,68 @@
+#pragma once
+
+#include "mqlpath/ast.h"
+#include "mqlpath/field_name.h"
+#include "mqlpath/value.h"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace mqlpath {
+/**
+ * A set of paths evaluated over a document together. The paths are folded and optimized like
+ * those of a PreparedPath and then merged into a trie on their leading Get, At and Traverse steps,
+ * so a prefix which several paths share is walked once per document instead of once per path.
+ * The steps following the shared prefix of a path, if any, are evaluated by evaluateBorrowed().
+ * A PathProjection is immutable and may be shared by threads.
+ */
+class PathProjection {
+public:
+    explicit PathProjection(const std::vector<Path>& paths);
+
+    /**
+     * Evaluates all paths over the borrowed document, replacing the contents of 'outputs' with
+     * one result per path, in the order of the paths. Each result is the one evaluate() returns
+     * for its path alone.
+     */
+    void evaluate(const Value& input, std::vector<Value>& outputs) const;
+
+    std::vector<Value> evaluate(const Value& input) const;
+
+    size_t size() const {
+        return _size;
+    }
+
+    /**
+     * Number of nodes of the trie, one per distinct prefix.
+     */
+    size_t getNodeCount() const {
+        return _nodes.size();
+    }
+
+private:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    struct Node {
+        // Paths which end at this node.
+        std::vector<size_t> outputs;
+        // Paths which continue with steps the trie does not merge, and those steps.
+        std::vector<std::pair<size_t, Path>> residuals;
+        std::vector<std::pair<FieldName, size_t>> gets;
+        std::vector<std::pair<int32_t, size_t>> ats;
+        // Root of the inner paths of the paths which end with a Traverse.
+        size_t traverse{npos};
+        // For the root of the inner paths of a Traverse, all paths below it.
+        std::vector<size_t> traversed;
+    };
+
+    struct Builder;
+
+    void evaluate(size_t node, const Value& value, std::vector<Value>& outputs) const;
+    void evaluateTraverse(size_t node, const Value& value, std::vector<Value>& outputs) const;
+
+    size_t _size{0};
+    // The root is the first node.
+    std::vector<Node> _nodes;
+};
+}  // namespace mqlpath
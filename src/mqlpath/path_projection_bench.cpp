@@ -0,0 +1,48 @@
+#include "mqlpath/ast_make.h"
+#include "mqlpath/corpus_generator.h"
+#include "mqlpath/path_projection.h"
+#include "mqlpath/prepared_path.h"
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+namespace mqlpath {
+TEST_CASE("Separate paths vs one projection", "[path_projection][benchmark]") {
+    CorpusOptions options{};
+    options.width = 20;
+    CorpusGenerator generator{options};
+    const auto documents = generator.documents(1000);
+
+    // 30 extractions below the same two objects, as a projection of many fields would do.
+    std::vector<Path> paths{};
+    for (size_t field = 0; field < 10; ++field) {
+        auto name = CorpusGenerator::fieldName(field);
+        paths.emplace_back(ast::get(name, ast::id()));
+        paths.emplace_back(ast::get("f0", ast::get(name, ast::id())));
+        paths.emplace_back(ast::get("f0", ast::get("f0", ast::get(name, ast::id()))));
+    }
+    std::vector<PreparedPath> prepared{};
+    for (const auto& path : paths) {
+        prepared.emplace_back(path);
+    }
+    PathProjection projection{paths};
+
+    std::vector<Value> outputs{};
+    BENCHMARK("PreparedPath per path, 1000 documents") {
+        for (const auto& document : documents) {
+            outputs.clear();
+            for (const auto& path : prepared) {
+                outputs.emplace_back(path.evaluate(document));
+            }
+        }
+        return outputs.size();
+    };
+
+    BENCHMARK("PathProjection, 1000 documents") {
+        for (const auto& document : documents) {
+            projection.evaluate(document, outputs);
+        }
+        return outputs.size();
+    };
+}
+}  // namespace mqlpath
@@ -0,0 +1,83 @@
+#include "mqlpath/ast_eval.h"
+#include "mqlpath/ast_make.h"
+#include "mqlpath/path_projection.h"
+#include "mqlpath/random_generator.h"
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+namespace mqlpath {
+TEST_CASE("projection shares prefixes", "[path_projection]") {
+    PathProjection projection{{
+        ast::get("a", ast::get("b", ast::id())),
+        ast::get("a", ast::get("c", ast::id())),
+        ast::compose(ast::get("a", ast::id()), ast::get("b", ast::id())),
+        ast::get("a", ast::traverse(ast::get("d", ast::id()))),
+        ast::get("a", ast::traverse(ast::get("e", ast::id()))),
+        ast::get("x", ast::at(1, ast::id())),
+    }};
+    // The root, a, a.b, a.c, the inner root of the Traverse, d, e, x and x[1].
+    REQUIRE(projection.getNodeCount() == 9);
+    REQUIRE(projection.size() == 6);
+
+    auto document = ast::value(Object{{
+        {"a", ast::value(Object{{{"b", ast::value(1)}, {"c", ast::value(2)}}})},
+        {"x", ast::value(std::vector<int32_t>{3, 4})},
+    }});
+    auto outputs = projection.evaluate(document);
+    REQUIRE(outputs.size() == 6);
+    REQUIRE(ast::value(1) == outputs[0]);
+    REQUIRE(ast::value(2) == outputs[1]);
+    REQUIRE(ast::value(1) == outputs[2]);
+    REQUIRE(ast::nothing() == outputs[3]);
+    REQUIRE(ast::nothing() == outputs[4]);
+    REQUIRE(ast::value(4) == outputs[5]);
+}
+
+TEST_CASE("projection traverses arrays once for all paths", "[path_projection]") {
+    PathProjection projection{{
+        ast::get("a", ast::traverse(ast::get("b", ast::id()))),
+        ast::get("a", ast::traverse(ast::get("c", ast::defaultPath(0)))),
+        ast::compose(ast::get("a", ast::traverse(ast::get("b", ast::id()))), ast::at(0, ast::id())),
+    }};
+
+    auto document = ast::value(Object{{
+        {"a",
+         Value::make<ArrayValue>(std::vector<Value>{
+             ast::value(Object{{{"b", ast::value(1)}}}),
+             ast::value(5),
+             Value::make<ArrayValue>(std::vector<Value>{
+                 ast::value(Object{{{"b", ast::value(2)}, {"c", ast::value(3)}}}),
+             }),
+         })},
+    }});
+    auto outputs = projection.evaluate(document);
+    REQUIRE(Value::make<ArrayValue>(std::vector<Value>{
+                ast::value(1), ast::value(std::vector<int32_t>{2})}) == outputs[0]);
+    REQUIRE(Value::make<ArrayValue>(std::vector<Value>{
+                ast::value(0), ast::value(0), ast::value(std::vector<int32_t>{3})}) == outputs[1]);
+    REQUIRE(ast::value(1) == outputs[2]);
+}
+
+TEST_CASE("projection matches evaluating each path", "[path_projection]") {
+    RandomGenerator generator{20240917};
+    std::vector<Value> outputs{};
+    for (int i = 0; i < 500; ++i) {
+        std::vector<Path> paths{};
+        for (int j = 0; j < 8; ++j) {
+            paths.emplace_back(generator.path(4));
+        }
+        PathProjection projection{paths};
+
+        for (int j = 0; j < 5; ++j) {
+            auto document = generator.value(3);
+            INFO(document);
+            projection.evaluate(document, outputs);
+            REQUIRE(outputs.size() == paths.size());
+            for (size_t k = 0; k < paths.size(); ++k) {
+                INFO(paths[k]);
+                REQUIRE(evaluate(paths[k], document) == outputs[k]);
+            }
+        }
+    }
+}
+}  // namespace mqlpath
@@ -0,0 +1,64 @@
+#include "mqlpath/prepared_path.h"
+#include "mqlpath/bson_eval.h"
+#include "mqlpath/path_dependencies.h"
+#include "mqlpath/path_optimizer.h"
+#include <algorithm>
+
+namespace mqlpath {
+PreparedPath::PreparedPath(const Path& path) : PreparedPath(path, ValueShape{}) {}
+
+PreparedPath::PreparedPath(const Path& path, const ValueShape& input)
+    : _path(optimize(specialize(foldConstants(path, _foldedCount), input, _outputShape))),
+      _program(compile(_path)),
+      _readSet(mqlpath::getReadSet(_path)) {}
+
+Value PreparedPath::evaluate(Value&& input) const {
+    return _program.run(std::move(input));
+}
+
+Value PreparedPath::evaluate(const Value& input) const {
+    return _program.run(input);
+}
+
+BorrowedValue PreparedPath::evaluateBorrowed(const Value& input) const {
+    return mqlpath::evaluateBorrowed(_path, input);
+}
+
+Value PreparedPath::evaluate(BsonView input) const {
+    return detail::evaluateFolded(_path, input);
+}
+
+void PreparedPath::evaluateBatch(std::span<const Value> inputs, std::vector<Value>& outputs) const {
+    outputs.clear();
+    outputs.reserve(inputs.size());
+    PathProgram::Frames frames{};
+    for (const auto& input : inputs) {
+        outputs.emplace_back(_program.run(input, frames));
+    }
+}
+
+void PreparedPath::evaluateBatch(std::span<const Value> inputs, ColumnarBatch& outputs) const {
+    outputs.clear();
+    outputs.reserve(inputs.size());
+    PathProgram::Frames frames{};
+    for (const auto& input : inputs) {
+        outputs.append(_program.run(input, frames));
+    }
+}
+
+void PreparedPath::evaluateBatch(std::span<const Value> inputs,
+                                 std::vector<Value>& outputs,
+                                 WorkStealingPool& pool,
+                                 size_t chunkSize) const {
+    chunkSize = std::max<size_t>(chunkSize, 1);
+    outputs.resize(inputs.size());
+    std::vector<PathProgram::Frames> frames(pool.getWorkerCount());
+    pool.parallelFor((inputs.size() + chunkSize - 1) / chunkSize, [&](size_t chunk, size_t worker) {
+        const size_t first = chunk * chunkSize;
+        const size_t last = std::min(first + chunkSize, inputs.size());
+        for (size_t index = first; index < last; ++index) {
+            outputs[index] = _program.run(inputs[index], frames[worker]);
+        }
+    });
+}
+}  // namespace mqlpath
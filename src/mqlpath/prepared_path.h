@@ -0,0 +1,115 @@
+#pragma once
+
+#include "mqlpath/ast.h"
+#include "mqlpath/ast_eval.h"
+#include "mqlpath/bson.h"
+#include "mqlpath/columnar_batch.h"
+#include "mqlpath/field_set.h"
+#include "mqlpath/path_program.h"
+#include "mqlpath/value.h"
+#include "mqlpath/value_shape.h"
+#include "mqlpath/work_stealing_pool.h"
+#include <span>
+#include <vector>
+
+namespace mqlpath {
+/**
+ * A path prepared once for evaluation over many externally supplied documents. The constant
+ * expressions of the path are folded and the path is optimized and compiled at construction, so
+ * evaluate() neither builds an Expression around the document nor walks the Path tree. A
+ * PreparedPath is immutable and may be shared by threads.
+ */
+class PreparedPath {
+public:
+    explicit PreparedPath(const Path& path);
+
+    /**
+     * Prepares the path for documents of the given shape, which lets specialize() remove the
+     * steps whose outcome the shape decides. Evaluating documents of another shape may yield
+     * wrong results.
+     */
+    PreparedPath(const Path& path, const ValueShape& input);
+
+    /**
+     * Evaluates the path taking ownership of the document, which lets Field, Drop and Keep modify
+     * it without copying.
+     */
+    Value evaluate(Value&& input) const;
+
+    /**
+     * Evaluates the path over a borrowed document. The document is shared, not copied, and is
+     * left unchanged.
+     */
+    Value evaluate(const Value& input) const;
+
+    /**
+     * Evaluates the path over a borrowed document without copying it, see evaluateBorrowed().
+     * Only the folded and optimized path is used, not the compiled program.
+     */
+    BorrowedValue evaluateBorrowed(const Value& input) const;
+
+    /**
+     * Evaluates the path over a BSON document in place, see evaluate(const Path&, BsonView). Only
+     * the folded and optimized path is used, not the compiled program.
+     */
+    Value evaluate(BsonView input) const;
+
+    /**
+     * Evaluates the path over a batch of borrowed documents, replacing the contents of 'outputs'
+     * with one result per document in the same order. The capacity of 'outputs' and the
+     * interpreter's frame stack are reused across the batch.
+     */
+    void evaluateBatch(std::span<const Value> inputs, std::vector<Value>& outputs) const;
+
+    /**
+     * Parallel evaluateBatch(): the batch is split into chunks of 'chunkSize' documents which are
+     * run by the workers of 'pool', each with its own frame stack. Every result is written to the
+     * position of its document, so the outputs are the same as those of the serial variant.
+     */
+    void evaluateBatch(std::span<const Value> inputs,
+                       std::vector<Value>& outputs,
+                       WorkStealingPool& pool,
+                       size_t chunkSize = kDefaultChunkSize) const;
+
+    static constexpr size_t kDefaultChunkSize = 256;
+
+    /**
+     * evaluateBatch() appending the results to typed columns instead of a vector of Values, meant
+     * for paths which extract scalars. 'outputs' is cleared first and keeps its capacity.
+     */
+    void evaluateBatch(std::span<const Value> inputs, ColumnarBatch& outputs) const;
+
+    const PathProgram& getProgram() const {
+        return _program;
+    }
+
+    /**
+     * Number of Const and Default expressions which were evaluated at construction.
+     */
+    size_t getFoldedCount() const {
+        return _foldedCount;
+    }
+
+    /**
+     * The parts of a document which the result depends on, see getReadSet(const Path&). Readers
+     * may build only these parts of the documents they pass to evaluate().
+     */
+    const FieldSet& getReadSet() const {
+        return _readSet;
+    }
+
+    /**
+     * The shape of the results, as inferred from the shape of the documents.
+     */
+    const ValueShape& getOutputShape() const {
+        return _outputShape;
+    }
+
+private:
+    size_t _foldedCount{0};
+    ValueShape _outputShape;
+    Path _path;
+    PathProgram _program;
+    FieldSet _readSet;
+};
+}  // namespace mqlpath
@@ -0,0 +1,226 @@
+#include "mqlpath/ast_eval.h"
+#include "mqlpath/ast_make.h"
+#include "mqlpath/corpus_generator.h"
+#include "mqlpath/prepared_path.h"
+#include "mqlpath/value.h"
+#include "mqlpath/value_shape.h"
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <thread>
+
+namespace mqlpath {
+TEST_CASE("Per-document vs batch evaluation", "[prepared][benchmark]") {
+    std::vector<Value> documents{};
+    for (int32_t i = 0; i < 1000; ++i) {
+        documents.emplace_back(ast::value(Object{{
+            {"id", ast::value(i)},
+            {"name", ast::value("document " + std::to_string(i))},
+            {"a", ast::value(Object{{{"b", ast::value(i % 7)}}})},
+            {"tags", ast::value(std::vector<std::string>{"x", "y", "z"})},
+        }}));
+    }
+
+    std::vector<std::pair<std::string, Path>> paths{};
+    paths.emplace_back("Get a.b", ast::get("a", ast::get("b", ast::id())));
+    paths.emplace_back("Traverse Default", ast::get("tags", ast::traverse(ast::defaultPath(0))));
+    paths.emplace_back("Field Const",
+                       ast::compose(ast::field("id", ast::constPath(0)), ast::drop({"tags"})));
+
+    for (const auto& [name, path] : paths) {
+        BENCHMARK("Expression per document " + name) {
+            std::vector<Value> outputs{};
+            outputs.reserve(documents.size());
+            for (const auto& document : documents) {
+                outputs.emplace_back(evaluate(ast::evalPath(path, document)));
+            }
+            return outputs;
+        };
+
+        BENCHMARK("PreparedPath per document " + name) {
+            PreparedPath prepared{path};
+            std::vector<Value> outputs{};
+            outputs.reserve(documents.size());
+            for (const auto& document : documents) {
+                outputs.emplace_back(prepared.evaluate(document));
+            }
+            return outputs;
+        };
+
+        std::vector<Value> outputs{};
+        BENCHMARK("PreparedPath batch " + name) {
+            PreparedPath prepared{path};
+            prepared.evaluateBatch(documents, outputs);
+            return outputs.size();
+        };
+    }
+}
+
+TEST_CASE("Parallel batch scaling", "[prepared][benchmark]") {
+    std::vector<Value> documents{};
+    for (int32_t i = 0; i < 10000; ++i) {
+        Array items{};
+        for (int32_t j = 0; j < 8; ++j) {
+            items.emplace_back(ast::value(Object{{{"id", ast::value(i + j)}}}));
+        }
+        documents.emplace_back(ast::value(Object{{
+            {"id", ast::value(i)},
+            {"items", Value::make<ArrayValue>(std::move(items))},
+        }}));
+    }
+    PreparedPath path{ast::compose(ast::drop({"id"}),
+                                   ast::field("items", ast::traverse(ast::get("id", ast::id()))))};
+
+    std::vector<Value> outputs{};
+    BENCHMARK("Serial batch") {
+        path.evaluateBatch(documents, outputs);
+        return outputs.size();
+    };
+
+    const size_t maxWorkers = std::max(4u, std::thread::hardware_concurrency());
+    for (size_t workers = 1; workers <= maxWorkers; workers *= 2) {
+        WorkStealingPool pool{workers};
+        BENCHMARK("Parallel batch " + std::to_string(workers) + " workers") {
+            path.evaluateBatch(documents, outputs, pool);
+            return outputs.size();
+        };
+    }
+}
+
+TEST_CASE("Value vs columnar batch output", "[prepared][benchmark]") {
+    std::vector<Value> documents{};
+    for (int32_t i = 0; i < 10000; ++i) {
+        auto b = i % 10 == 0 ? ast::nothing() : ast::value(i);
+        documents.emplace_back(ast::value(Object{{
+            {"id", ast::value(i)},
+            {"a", ast::value(Object{{{"b", std::move(b)}}})},
+        }}));
+    }
+    PreparedPath path{ast::get("a", ast::get("b", ast::id()))};
+
+    auto sumValues = [](const std::vector<Value>& values) {
+        int64_t sum = 0;
+        for (const auto& value : values) {
+            if (auto scalarValue = value.cast<ScalarValue>(); scalarValue != nullptr) {
+                if (auto number = std::get_if<int32_t>(&scalarValue->scalar); number != nullptr) {
+                    sum += *number;
+                }
+            }
+        }
+        return sum;
+    };
+    // Invalid rows are zero, so the column is summed without looking at the bitmap.
+    auto sumColumn = [](const ColumnarBatch& columns) {
+        int64_t sum = 0;
+        for (size_t row = 0; row < columns.size(); ++row) {
+            sum += columns.getInt32s().values[row];
+        }
+        return sum;
+    };
+
+    std::vector<Value> values{};
+    BENCHMARK("Value batch evaluate and sum") {
+        path.evaluateBatch(documents, values);
+        return sumValues(values);
+    };
+    BENCHMARK("Value batch sum only") {
+        return sumValues(values);
+    };
+
+    ColumnarBatch columns{};
+    BENCHMARK("Columnar batch evaluate and sum") {
+        path.evaluateBatch(documents, columns);
+        return sumColumn(columns);
+    };
+    BENCHMARK("Columnar batch sum only") {
+        return sumColumn(columns);
+    };
+}
+
+TEST_CASE("Shared vs borrowed evaluation of a read-only path", "[prepared][benchmark]") {
+    CorpusGenerator generator{CorpusOptions{}};
+    const auto documents = generator.documents(1000);
+    // f0 is an object and f1 an array in every object above the last level.
+    auto path = ast::get("f0", ast::get("f1", ast::at(3, ast::id())));
+    PreparedPath prepared{path};
+
+    BENCHMARK("evaluate 1000 documents") {
+        size_t found = 0;
+        for (const auto& document : documents) {
+            found += !isNothing(evaluate(path, document));
+        }
+        return found;
+    };
+
+    BENCHMARK("PreparedPath 1000 documents") {
+        size_t found = 0;
+        for (const auto& document : documents) {
+            found += !isNothing(prepared.evaluate(document));
+        }
+        return found;
+    };
+
+    BENCHMARK("PreparedPath borrowed 1000 documents") {
+        size_t found = 0;
+        for (const auto& document : documents) {
+            found += !isNothing(prepared.evaluateBorrowed(document).get());
+        }
+        return found;
+    };
+}
+
+TEST_CASE("Update paths over owned documents", "[prepared][benchmark]") {
+    CorpusOptions options{};
+    options.width = 50;
+    CorpusGenerator generator{options};
+    auto documents = generator.documents(100);
+
+    std::vector<std::pair<std::string, Path>> paths{};
+    paths.emplace_back("Field f0 (Field f0 (Field f2 Const 1))",
+                       ast::field("f0", ast::field("f0", ast::field("f2", ast::constPath(1)))));
+    paths.emplace_back("Field f49 Const 1", ast::field("f49", ast::constPath(1)));
+
+    for (const auto& [name, path] : paths) {
+        PreparedPath prepared{path};
+        // The paths give the same result when applied again, so every run updates the results of
+        // the previous one, which no one else holds.
+        BENCHMARK("100 documents " + name) {
+            for (auto& document : documents) {
+                document = prepared.evaluate(std::move(document));
+            }
+            return documents.size();
+        };
+    }
+}
+
+TEST_CASE("Paths prepared for any input vs a known shape", "[prepared][benchmark]") {
+    std::vector<Value> documents{};
+    for (int32_t i = 0; i < 1000; ++i) {
+        documents.emplace_back(ast::value(Object{{
+            {"id", ast::value(i)},
+            {"a", ast::value(Object{{{"b", ast::value(i % 7)}}})},
+        }}));
+    }
+    ValueShape shape{0};
+    for (const auto& document : documents) {
+        shape.unite(ValueShape::of(document));
+    }
+    // Guards written for documents of any shape, which never apply to these.
+    auto path = ast::compose(
+        ast::obj(),
+        ast::get("a", ast::compose(ast::obj(), ast::get("b", ast::defaultPath(0)))));
+
+    const PreparedPath forAny{path};
+    const PreparedPath forShape{path, shape};
+    for (const auto& [name, prepared] :
+         {std::pair{"any", &forAny}, std::pair{"shape", &forShape}}) {
+        BENCHMARK(std::string{"PreparedPath for "} + name) {
+            size_t found = 0;
+            for (const auto& document : documents) {
+                found += !isNothing(prepared->evaluateBorrowed(document).get());
+            }
+            return found;
+        };
+    }
+}
+}  // namespace mqlpath
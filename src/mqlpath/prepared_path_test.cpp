@@ -0,0 +1,170 @@
+#include "mqlpath/ast_make.h"
+#include "mqlpath/prepared_path.h"
+#include <catch2/catch_test_macros.hpp>
+#include <lexer.h>
+#include <parser.h>
+#include <utility>
+
+namespace mqlpath {
+namespace {
+Path parsePath(const std::string& code) {
+    auto expression = "EvalPath " + code + " Nothing";
+    Lexer lexer(expression);
+    Driver driver{};
+    Parser parser{lexer, &driver};
+    auto result = parser.parse();
+
+    if (result != 0) {
+        std::cout << driver.getErrors();
+    }
+
+    REQUIRE(result == 0);
+    REQUIRE(!driver.getErrors().hasErrors());
+    return driver.getAST().cast<EvalPath>()->path;
+}
+}  // namespace
+
+TEST_CASE("prepared path evaluates external documents", "[prepared]") {
+    PreparedPath path{parsePath(R"_(Get "a" (Traverse Get "b" Id))_")};
+
+    Object first{{{"a", ast::value(Object{{{"b", ast::value(1)}}})}}};
+    REQUIRE(ast::value(1) == path.evaluate(ast::value(first)));
+
+    Object second{{{"a", Value::make<ArrayValue>(std::vector<Value>{
+                             ast::value(Object{{{"b", ast::value(2)}}}),
+                             ast::value(3),
+                             ast::value(Object{{{"b", ast::value(4)}}}),
+                         })}}};
+    REQUIRE(ast::value(std::vector<int32_t>{2, 4}) == path.evaluate(ast::value(second)));
+    REQUIRE(ast::nothing() == path.evaluate(ast::value(5)));
+
+    auto bytes = toBson(second);
+    REQUIRE(ast::value(std::vector<int32_t>{2, 4}) == path.evaluate(BsonView::document(bytes)));
+}
+
+TEST_CASE("prepared path leaves borrowed documents unchanged", "[prepared]") {
+    PreparedPath path{parsePath(R"_((Field "a" Const 7) * (Drop "b"))_")};
+
+    auto document = ast::value(Object{{{"a", ast::value(1)}, {"b", ast::value(2)}}});
+    auto expected = ast::value(Object{{{"a", ast::value(7)}}});
+
+    REQUIRE(expected == path.evaluate(document));
+    REQUIRE(ast::value(Object{{{"a", ast::value(1)}, {"b", ast::value(2)}}}) == document);
+    REQUIRE(expected == path.evaluate(std::move(document)));
+}
+
+TEST_CASE("prepared path folds constant expressions once", "[prepared]") {
+    PreparedPath path{parsePath(R"_(Traverse Const EvalPath (Get "a" Id) {a: [1, 2]})_")};
+    REQUIRE(path.getFoldedCount() == 1);
+
+    auto result = path.evaluate(ast::value(std::vector<int32_t>{1, 2, 3}));
+    auto expected = ast::value(std::vector<int32_t>{1, 2});
+    REQUIRE(Value::make<ArrayValue>(std::vector<Value>{expected, expected, expected}) == result);
+
+    // Every element refers to the same folded value.
+    const auto& elements = std::as_const(result).cast<ArrayValue>()->array;
+    REQUIRE(elements[0].isShared());
+    REQUIRE(std::as_const(elements[0]).cast<ArrayValue>() ==
+            std::as_const(elements[2]).cast<ArrayValue>());
+}
+
+TEST_CASE("prepared path evaluates batches in order", "[prepared]") {
+    PreparedPath path{parsePath(R"_((Field "a" Traverse Default 0) * (Get "a" Id))_")};
+
+    std::vector<Value> inputs{
+        ast::value(Object{{{"a", ast::value(std::vector<int32_t>{1, 2})}}}),
+        ast::value(5),
+        ast::value(Object{{{"b", ast::value(1)}}}),
+        ast::value(Object{{{"a", ast::value(3)}}}),
+    };
+    std::vector<Value> outputs{ast::value(42)};
+    path.evaluateBatch(inputs, outputs);
+
+    REQUIRE(outputs.size() == inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        REQUIRE(path.evaluate(inputs[i]) == outputs[i]);
+    }
+    REQUIRE(ast::value(std::vector<int32_t>{1, 2}) == outputs[0]);
+    REQUIRE(ast::value(0) == outputs[2]);
+
+    path.evaluateBatch({}, outputs);
+    REQUIRE(outputs.empty());
+}
+
+TEST_CASE("parallel batches match serial evaluation", "[prepared]") {
+    PreparedPath path{parsePath(R"_((Field "a" Traverse Get "b" Id) * (Drop "c"))_")};
+
+    std::vector<Value> inputs{};
+    for (int32_t i = 0; i < 1000; ++i) {
+        Array elements{};
+        for (int32_t j = 0; j < i % 5; ++j) {
+            elements.emplace_back(ast::value(Object{{{"b", ast::value(i * j)}}}));
+        }
+        inputs.emplace_back(ast::value(Object{{
+            {"a", Value::make<ArrayValue>(std::move(elements))},
+            {"c", ast::value(i)},
+        }}));
+    }
+
+    std::vector<Value> expected{};
+    path.evaluateBatch(inputs, expected);
+
+    WorkStealingPool pool{4};
+    for (size_t chunkSize : {1, 7, 256, 5000}) {
+        std::vector<Value> outputs{};
+        path.evaluateBatch(inputs, outputs, pool, chunkSize);
+        REQUIRE(outputs == expected);
+    }
+}
+
+TEST_CASE("prepared path evaluates batches into columns", "[prepared]") {
+    PreparedPath path{parsePath(R"_(Get "a" Get "b" Id)_")};
+
+    std::vector<Value> inputs{
+        ast::value(Object{{{"a", ast::value(Object{{{"b", ast::value(1)}}})}}}),
+        ast::value(Object{{{"a", ast::value(1)}}}),
+        ast::value(Object{{{"a", ast::value(Object{{{"b", ast::value("x")}}})}}}),
+    };
+    ColumnarBatch outputs{};
+    path.evaluateBatch(inputs, outputs);
+
+    REQUIRE(outputs.size() == 3);
+    REQUIRE(outputs.getInt32s().validity.test(0));
+    REQUIRE(outputs.getInt32s().values[0] == 1);
+    REQUIRE(!outputs.getInt32s().validity.test(1));
+    REQUIRE(!outputs.getStrings().validity.test(1));
+    REQUIRE(outputs.getStrings().getValue(2) == "x");
+
+    path.evaluateBatch(std::span{inputs}.first(1), outputs);
+    REQUIRE(outputs.size() == 1);
+}
+
+TEST_CASE("prepared path updates owned documents in place", "[prepared]") {
+    PreparedPath path{parsePath(R"_(Field "a" (Field "b" (Drop "x")) * Field "c" Const 4)_")};
+
+    auto document = ast::value(Object{{
+        {"a", ast::value(Object{{{"b", ast::value(Object{{{"x", ast::value(1)}}})}}})},
+        {"c", ast::value(3)},
+    }});
+    const auto* object = &std::as_const(document).cast<ObjectValue>()->object;
+    const auto* b = &std::as_const(*object->findValue("a")).cast<ObjectValue>()->object;
+
+    auto result = path.evaluate(std::move(document));
+    REQUIRE(&std::as_const(result).cast<ObjectValue>()->object == object);
+    REQUIRE(&std::as_const(*object->findValue("a")).cast<ObjectValue>()->object == b);
+    REQUIRE(ast::value(Object{{
+                {"a", ast::value(Object{{{"b", ast::value(Object{})}}})},
+                {"c", ast::value(4)},
+            }}) == result);
+}
+
+TEST_CASE("prepared path removes repeated fields set to Nothing", "[prepared]") {
+    PreparedPath path{parsePath(R"_(Field "a" Const Nothing)_")};
+    auto document = ast::value(Object{{
+        {"a", ast::value(1)},
+        {"b", ast::value(2)},
+        {"a", ast::value(3)},
+    }});
+    REQUIRE(ast::value(Object{{{"b", ast::value(2)}}}) == path.evaluate(std::move(document)));
+}
+}  // namespace mqlpath
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "mqlpath/ast.h"
+#include "mqlpath/ast_make.h"
+#include "mqlpath/value.h"
+#include <random>
+#include <string>
+#include <vector>
+
+namespace mqlpath {
+/**
+ * Generates random paths and documents over a small set of field names, so that the generated
+ * paths actually hit the fields of the generated documents. Used by the randomized tests.
+ */
+class RandomGenerator {
+public:
+    explicit RandomGenerator(uint32_t seed) : _random(seed) {}
+
+    Path path(int depth) {
+        const int kind = depth > 0 ? uniform(0, 15) : uniform(0, 7);
+        switch (kind) {
+            case 0:
+                return ast::id();
+            case 1:
+                return ast::constPath(value(1));
+            case 2:
+                return ast::defaultPath(Expression{ast::expr(value(1))});
+            case 3:
+                return ast::drop(fieldNames());
+            case 4:
+                return ast::keep(fieldNames());
+            case 5:
+                return ast::obj();
+            case 6:
+                return ast::arr();
+            case 7:
+                return ast::lambda(1);
+            case 8:
+            case 9:
+                return ast::field(fieldName(), path(depth - 1));
+            case 10:
+            case 11:
+                return ast::get(fieldName(), path(depth - 1));
+            case 12:
+                return ast::at(uniform(0, 2), path(depth - 1));
+            case 13:
+                return ast::traverse(path(depth - 1));
+            default:
+                return ast::compose(path(depth - 1), path(depth - 1));
+        }
+    }
+
+    Value value(int depth) {
+        const int kind = depth > 0 ? uniform(0, 6) : uniform(0, 3);
+        switch (kind) {
+            case 0:
+                return ast::nothing();
+            case 1:
+                return ast::value(uniform(0, 9));
+            case 2:
+                return ast::value("s" + std::to_string(uniform(0, 9)));
+            case 3:
+                return ast::value(uniform(0, 1) == 1);
+            case 4: {
+                Array array{};
+                for (int i = uniform(0, 3); i > 0; --i) {
+                    array.emplace_back(value(depth - 1));
+                }
+                return Value::make<ArrayValue>(std::move(array));
+            }
+            default: {
+                Object object{};
+                for (int i = uniform(0, 3); i > 0; --i) {
+                    object.setValue(fieldName(), value(depth - 1));
+                }
+                return ast::value(std::move(object));
+            }
+        }
+    }
+
+private:
+    int uniform(int min, int max) {
+        return std::uniform_int_distribution<int>{min, max}(_random);
+    }
+
+    FieldName fieldName() {
+        static const FieldName names[] = {"a", "b", "c"};
+        return names[uniform(0, 2)];
+    }
+
+    std::vector<FieldName> fieldNames() {
+        std::vector<FieldName> names{fieldName()};
+        if (uniform(0, 1) == 1) {
+            names.emplace_back(fieldName());
+        }
+        return names;
+    }
+
+    std::mt19937 _random;
+};
+}  // namespace mqlpath
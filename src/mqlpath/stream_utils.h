@@ -1,9 +1,10 @@
 #pragma once
 #include <sstream>
+#include <vector>
 
 namespace mqlpath {
-template <typename T>
-std::ostream& operator<<(std::ostream& os, const std::vector<T>& vector) {
+template <typename T, typename A>
+std::ostream& operator<<(std::ostream& os, const std::vector<T, A>& vector) {
     bool first = true;
     for (const auto& element : vector) {
         if (!first) {
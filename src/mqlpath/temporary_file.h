@@ -0,0 +1,39 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace mqlpath {
+/**
+ * File in the temporary directory which is removed at the end of the test. Used by the tests of
+ * code which maps or streams files.
+ */
+class TemporaryFile {
+public:
+    explicit TemporaryFile(const std::string& name)
+        : _path(std::filesystem::temp_directory_path() / ("mqlpath_" + name)) {}
+
+    ~TemporaryFile() {
+        std::filesystem::remove(_path);
+    }
+
+    std::string getName() const {
+        return _path.string();
+    }
+
+    void write(const std::string& bytes) const {
+        std::ofstream output{_path, std::ios::binary};
+        output << bytes;
+    }
+
+    std::string read() const {
+        std::ifstream input{_path, std::ios::binary};
+        return std::string{std::istreambuf_iterator<char>{input}, {}};
+    }
+
+private:
+    std::filesystem::path _path;
+};
+}  // namespace mqlpath
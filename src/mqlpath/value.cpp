@@ -1,4 +1,8 @@
 #include <algorithm>
+#include <functional>
+#include <memory>
+#include <new>
+#include <utility>
 #include "mqlpath/stream_utils.h"
 #include "mqlpath/value.h"
 
@@ -35,23 +39,257 @@ private:
     std::ostream& _os;
 };
 
-bool contains(const std::vector<std::string>& vector, const std::string& element) {
-    return std::find(begin(vector), end(vector), element) != end(vector);
+class ValueCopier {
+public:
+    explicit ValueCopier(const std::pmr::memory_resource* resource) : _resource(resource) {}
+
+    Value copy(const Value& value) {
+        if (value.getResource() != _resource) {
+            return value;
+        }
+        return value.visit(*this);
+    }
+
+    Value operator()(const Value&, const NothingValue&) {
+        return Value::make<NothingValue>();
+    }
+
+    Value operator()(const Value&, const ScalarValue& scalar) {
+        return Value::make<ScalarValue>(scalar.scalar);
+    }
+
+    Value operator()(const Value&, const ArrayValue& array) {
+        Array values{};
+        values.reserve(array.array.size());
+        for (const auto& element : array.array) {
+            values.emplace_back(copy(element));
+        }
+        return Value::make<ArrayValue>(std::move(values));
+    }
+
+    Value operator()(const Value&, const ObjectValue& object) {
+        const auto& names = object.object.getNames();
+        const auto& values = object.object.getValues();
+        Object::Fields fields{};
+        fields.reserve(names.size());
+        for (size_t position = 0; position < names.size(); ++position) {
+            fields.emplace_back(names[position], copy(values[position]));
+        }
+        return Value::make<ObjectValue>(Object{std::move(fields)});
+    }
+
+private:
+    const std::pmr::memory_resource* _resource;
+};
+
+// Bytes of the allocation of an object per field: its name and its value.
+constexpr size_t kFieldBytes = sizeof(FieldName) + sizeof(Value);
+static_assert(alignof(Value) <= alignof(FieldName) && sizeof(FieldName) % alignof(Value) == 0,
+              "the values follow the names in the allocation of an object");
+
+bool contains(const std::vector<FieldName>& vector, const FieldName& element) {
+    return findFieldName(vector.data(), vector.size(), element) != vector.size();
 }
 }  // namespace
 
-void Object::dropFields(const std::vector<std::string>& fieldNames) {
-    auto newEnd = std::remove_if(begin(_fields), end(_fields), [&fieldNames](const auto& field) {
-        return contains(fieldNames, field.name);
-    });
-    _fields.erase(newEnd, end(_fields));
+Object::Object(Fields fields) : _resource(mongodb::currentMemoryResource()) {
+    if (!fields.empty()) {
+        reallocate(fields.size());
+    }
+    for (auto& field : fields) {
+        new (_names + _size) FieldName(std::move(field.name));
+        new (_values + _size) Value(std::move(field.value));
+        ++_size;
+    }
+    if (_size > kIndexThreshold) {
+        _index.build(getNames());
+    }
+}
+
+// Copies are allocated from the current scope, as with the containers of Values.
+Object::Object(const Object& other)
+    : _resource(mongodb::currentMemoryResource()), _index(other._index) {
+    if (other._size != 0) {
+        reallocate(other._size);
+    }
+    std::uninitialized_copy_n(other._names, other._size, _names);
+    std::uninitialized_copy_n(other._values, other._size, _values);
+    _size = other._size;
+}
+
+Object::Object(Object&& other) noexcept
+    : _names(std::exchange(other._names, nullptr)),
+      _values(std::exchange(other._values, nullptr)),
+      _size(std::exchange(other._size, 0)),
+      _capacity(std::exchange(other._capacity, 0)),
+      _resource(other._resource),
+      _index(std::move(other._index)) {
+    other._index.clear();
+}
+
+Object& Object::operator=(const Object& other) {
+    if (this != &other) {
+        truncate(0);
+        if (_capacity < other._size) {
+            reallocate(other._size);
+        }
+        std::uninitialized_copy_n(other._names, other._size, _names);
+        std::uninitialized_copy_n(other._values, other._size, _values);
+        _size = other._size;
+        _index = other._index;
+    }
+    return *this;
+}
+
+Object& Object::operator=(Object&& other) noexcept {
+    if (this != &other) {
+        release();
+        _names = std::exchange(other._names, nullptr);
+        _values = std::exchange(other._values, nullptr);
+        _size = std::exchange(other._size, 0);
+        _capacity = std::exchange(other._capacity, 0);
+        _resource = other._resource;
+        _index = std::move(other._index);
+        other._index.clear();
+    }
+    return *this;
+}
+
+Object::~Object() {
+    release();
+}
+
+void Object::release() {
+    truncate(0);
+    if (_names != nullptr) {
+        _resource->deallocate(_names, _capacity * kFieldBytes, alignof(FieldName));
+    }
+    _names = nullptr;
+    _values = nullptr;
+    _capacity = 0;
+}
+
+void Object::reallocate(size_t capacity) {
+    auto names = static_cast<FieldName*>(
+        _resource->allocate(capacity * kFieldBytes, alignof(FieldName)));
+    auto values = reinterpret_cast<Value*>(names + capacity);
+    std::uninitialized_move_n(_names, _size, names);
+    std::uninitialized_move_n(_values, _size, values);
+    std::destroy_n(_names, _size);
+    std::destroy_n(_values, _size);
+    if (_names != nullptr) {
+        _resource->deallocate(_names, _capacity * kFieldBytes, alignof(FieldName));
+    }
+    _names = names;
+    _values = values;
+    _capacity = capacity;
+}
+
+void Object::truncate(size_t size) {
+    std::destroy(_names + size, _names + _size);
+    std::destroy(_values + size, _values + _size);
+    _size = size;
+}
+
+void Object::FieldIndex::build(std::span<const FieldName> names) {
+    size_t capacity = 32;
+    while (capacity < names.size() * 2) {
+        capacity *= 2;
+    }
+    _slots.assign(capacity, 0);
+    for (size_t position = 0; position < names.size(); ++position) {
+        insert(names, position);
+    }
+}
+
+void Object::FieldIndex::insert(std::span<const FieldName> names, size_t position) {
+    if ((position + 1) * 2 > _slots.size()) {
+        build(names);
+        return;
+    }
+
+    const size_t mask = _slots.size() - 1;
+    size_t slot = names[position].hash() & mask;
+    while (_slots[slot] != 0) {
+        slot = (slot + 1) & mask;
+    }
+    _slots[slot] = static_cast<uint32_t>(position + 1);
+}
+
+size_t Object::FieldIndex::find(std::span<const FieldName> names,
+                                const FieldName& fieldName) const {
+    const size_t mask = _slots.size() - 1;
+    size_t slot = fieldName.hash() & mask;
+    while (_slots[slot] != 0) {
+        size_t position = _slots[slot] - 1;
+        if (names[position] == fieldName) {
+            return position;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return npos;
 }
 
-void Object::keepFields(const std::vector<std::string>& fieldNames) {
-    auto newEnd = std::remove_if(begin(_fields), end(_fields), [&fieldNames](const auto& field) {
-        return !contains(fieldNames, field.name);
-    });
-    _fields.erase(newEnd, end(_fields));
+template <typename Predicate>
+void Object::eraseFieldsIf(Predicate predicate) {
+    size_t kept = 0;
+    for (size_t position = 0; position < _size; ++position) {
+        if (predicate(_names[position])) {
+            continue;
+        }
+        if (kept != position) {
+            _names[kept] = std::move(_names[position]);
+            _values[kept] = std::move(_values[position]);
+        }
+        ++kept;
+    }
+    if (kept != _size) {
+        truncate(kept);
+        rebuildIndex();
+    }
+}
+
+void Object::append(const FieldName& fieldName, Value value) {
+    if (_size == _capacity) {
+        reallocate(std::max<size_t>(_capacity * 2, 4));
+    }
+    new (_names + _size) FieldName(fieldName);
+    new (_values + _size) Value(std::move(value));
+    ++_size;
+    if (!_index.empty()) {
+        _index.insert(getNames(), _size - 1);
+    } else if (_size > kIndexThreshold) {
+        _index.build(getNames());
+    }
+}
+
+void Object::eraseFrom(size_t position) {
+    // The fields before 'position' have other names, as it is the first of its name.
+    const FieldName fieldName = _names[position];
+    size_t kept = position;
+    for (; position < _size; ++position) {
+        if (_names[position] == fieldName) {
+            continue;
+        }
+        _names[kept] = std::move(_names[position]);
+        _values[kept] = std::move(_values[position]);
+        ++kept;
+    }
+    truncate(kept);
+    rebuildIndex();
+}
+
+void Object::dropFields(const std::vector<FieldName>& fieldNames) {
+    eraseFieldsIf([&fieldNames](const FieldName& name) { return contains(fieldNames, name); });
+}
+
+void Object::keepFields(const std::vector<FieldName>& fieldNames) {
+    eraseFieldsIf([&fieldNames](const FieldName& name) { return !contains(fieldNames, name); });
+}
+
+Value copyOutOf(const Value& value, const std::pmr::memory_resource* resource) {
+    ValueCopier copier{resource};
+    return copier.copy(value);
 }
 
 std::ostream& operator<<(std::ostream& os, const Scalar& val) {
@@ -66,7 +304,14 @@ std::ostream& operator<<(std::ostream& os, const Value& val) {
 }
 
 std::ostream& operator<<(std::ostream& os, const Object& val) {
-    os << "{" << val._fields << "}";
+    os << "{";
+    for (size_t position = 0; position < val._size; ++position) {
+        if (position != 0) {
+            os << ", ";
+        }
+        os << Object::Field{val._names[position], val._values[position]};
+    }
+    os << "}";
     return os;
 }
 
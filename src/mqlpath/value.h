@@ -1,7 +1,14 @@
 #pragma once
+#include "mqlpath/allocator.h"
+#include "mqlpath/field_name.h"
+#include <algorithm>
 #include <iosfwd>
+#include <memory_resource>
 #include <mongodb/polyvalue.h>
+#include <span>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -14,6 +21,7 @@ struct ScalarValue;
 struct ArrayValue;
 struct ObjectValue;
 using Value = mongodb::PolyValue<NothingValue, ScalarValue, ArrayValue, ObjectValue>;
+using Array = std::vector<Value, ScopedAllocator<Value>>;
 
 inline bool isNothing(const Value& value) {
     return value.is<NothingValue>();
@@ -41,83 +49,213 @@ struct ScalarValue {
 };
 
 struct ArrayValue {
-    explicit ArrayValue(std::vector<Value> array) : array(std::move(array)) {}
+    explicit ArrayValue(Array array) : array(std::move(array)) {}
+    explicit ArrayValue(std::vector<Value> values)
+        : array(std::make_move_iterator(values.begin()), std::make_move_iterator(values.end())) {}
     bool operator==(const ArrayValue& other) const = default;
-    std::vector<Value> array;
+    Array array;
 };
 
+/**
+ * Fields are stored as two parallel arrays, names and values, so that lookups scan a contiguous
+ * array of atoms (see findFieldName) without striding over the values. Both arrays share one
+ * allocation, so copying an object allocates once, as for an array of fields. Like the
+ * containers of Values, it is allocated from the memory resource of the active
+ * mongodb::MemoryResourceScope.
+ */
 struct Object {
     struct Field {
         Field() {}
 
         bool operator==(const Field&) const = default;
 
-        Field(std::string name, Value value) : name(std::move(name)), value(std::move(value)) {}
-        std::string name;
+        Field(FieldName name, Value value) : name(std::move(name)), value(std::move(value)) {}
+        FieldName name;
         Value value;
     };
 
-    Object() {}
+    using Fields = std::vector<Field, ScopedAllocator<Field>>;
 
-    explicit Object(std::vector<Field> fields) : _fields(std::move(fields)) {}
+    /**
+     * Objects with more fields than this are looked up through a hash index.
+     */
+    static constexpr size_t kIndexThreshold = 16;
 
-    bool hasField(const std::string& fieldName) const {
-        return get(fieldName) != nullptr;
+    Object() : _resource(mongodb::currentMemoryResource()) {}
+
+    explicit Object(Fields fields);
+
+    Object(const Object& other);
+    Object(Object&& other) noexcept;
+    Object& operator=(const Object& other);
+    Object& operator=(Object&& other) noexcept;
+    ~Object();
+
+    bool hasField(const FieldName& fieldName) const {
+        return find(fieldName) != npos;
     }
 
-    const Value getValue(const std::string& fieldName) const {
-        auto field = get(fieldName);
-        if (field != nullptr) {
-            return field->value;
+    const Value getValue(const FieldName& fieldName) const {
+        auto position = find(fieldName);
+        if (position != npos) {
+            return _values[position];
         }
 
         return Value::make<NothingValue>();
     }
 
-    const void setValue(const std::string& fieldName, Value value) {
+    /**
+     * The value of the field without copying it, nullptr if there is no such field.
+     */
+    const Value* findValue(const FieldName& fieldName) const {
+        auto position = find(fieldName);
+        return position != npos ? &_values[position] : nullptr;
+    }
+
+    const void setValue(const FieldName& fieldName, Value value) {
         if (isNothing(value)) {
             dropFields({fieldName});
             return;
         }
 
-        auto field = get(fieldName);
-        if (field != nullptr) {
-            field->value = std::move(value);
+        auto position = find(fieldName);
+        if (position != npos) {
+            _values[position] = std::move(value);
+        } else {
+            append(fieldName, std::move(value));
+        }
+    }
+
+    /**
+     * Moves the value of the field out of the object to update it in place, returning Nothing if
+     * there is no such field. 'position' receives the position of the field, npos if there is
+     * none, for restoreValue(). The field holds no value until then, so the object must not be
+     * used in between.
+     */
+    Value releaseValue(const FieldName& fieldName, size_t& position) {
+        position = find(fieldName);
+        return position != npos ? std::move(_values[position]) : Value::make<NothingValue>();
+    }
+
+    /**
+     * Completes releaseValue(): stores the value at the position of the field without looking it
+     * up again, appends the field if it did not exist or, like setValue(), removes every field of
+     * that name if the value is Nothing.
+     */
+    void restoreValue(const FieldName& fieldName, size_t position, Value value) {
+        if (position == npos) {
+            if (!isNothing(value)) {
+                append(fieldName, std::move(value));
+            }
+        } else if (isNothing(value)) {
+            eraseFrom(position);
         } else {
-            _fields.emplace_back(fieldName, std::move(value));
+            _values[position] = std::move(value);
         }
     }
 
-    void dropFields(const std::vector<std::string>& fieldNames);
-    void keepFields(const std::vector<std::string>& fieldNames);
+    size_t size() const {
+        return _size;
+    }
+
+    std::span<const FieldName> getNames() const {
+        return {_names, _size};
+    }
 
-    bool operator==(const Object&) const = default;
+    std::span<const Value> getValues() const {
+        return {_values, _size};
+    }
+
+    void dropFields(const std::vector<FieldName>& fieldNames);
+    void keepFields(const std::vector<FieldName>& fieldNames);
+
+    bool operator==(const Object& other) const {
+        return std::ranges::equal(getNames(), other.getNames()) &&
+            std::ranges::equal(getValues(), other.getValues());
+    }
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
 
 private:
-    Field* get(const std::string& fieldName) {
-        auto pos = std::find_if(begin(_fields), end(_fields), [&fieldName](const Field& field) {
-            return field.name == fieldName;
-        });
-        if (pos == end(_fields)) {
-            return nullptr;
+    /**
+     * Open addressing hash table of positions in the name array. The index does not own the
+     * names, so it stays valid when the array reallocates, but it must be rebuilt whenever
+     * fields are removed.
+     */
+    class FieldIndex {
+    public:
+        bool empty() const {
+            return _slots.empty();
+        }
+
+        void clear() {
+            _slots.clear();
         }
-        return &*pos;
+
+        void build(std::span<const FieldName> names);
+        void insert(std::span<const FieldName> names, size_t position);
+        size_t find(std::span<const FieldName> names, const FieldName& fieldName) const;
+
+    private:
+        // Position of the field plus one, zero marks an empty slot.
+        std::vector<uint32_t, ScopedAllocator<uint32_t>> _slots;
+    };
+
+    size_t find(const FieldName& fieldName) const {
+        if (!_index.empty()) {
+            return _index.find(getNames(), fieldName);
+        }
+
+        auto position = findFieldName(_names, _size, fieldName);
+        return position != _size ? position : npos;
     }
 
-    const Field* get(const std::string& fieldName) const {
-        auto pos = std::find_if(begin(_fields), end(_fields), [&fieldName](const Field& field) {
-            return field.name == fieldName;
-        });
-        if (pos == end(_fields)) {
-            return nullptr;
+    /**
+     * Moves the fields to an allocation for 'capacity' fields, which must hold all of them.
+     */
+    void reallocate(size_t capacity);
+
+    /**
+     * Destroys the fields and frees their allocation.
+     */
+    void release();
+
+    /**
+     * Destroys the fields from 'size' on.
+     */
+    void truncate(size_t size);
+
+    void append(const FieldName& fieldName, Value value);
+
+    /**
+     * Removes the field at 'position' and the later fields of the same name.
+     */
+    void eraseFrom(size_t position);
+
+    /**
+     * Removes the fields whose name satisfies 'predicate', keeping the order of the others.
+     */
+    template <typename Predicate>
+    void eraseFieldsIf(Predicate predicate);
+
+    void rebuildIndex() {
+        if (_size > kIndexThreshold) {
+            _index.build(getNames());
+        } else {
+            _index.clear();
         }
-        return &*pos;
     }
 
     friend std::ostream& operator<<(std::ostream& os, const Object& val);
     friend std::ostream& operator<<(std::ostream& os, const Object::Field& val);
 
-    std::vector<Field> _fields;
+    // The values follow the names in the same allocation, whose size is given by '_capacity'.
+    FieldName* _names{nullptr};
+    Value* _values{nullptr};
+    size_t _size{0};
+    size_t _capacity{0};
+    std::pmr::memory_resource* _resource;
+    FieldIndex _index;
 };
 
 struct ObjectValue {
@@ -126,6 +264,12 @@ struct ObjectValue {
     Object object;
 };
 
+/**
+ * Returns a copy of the value which does not depend on the given memory resource: the nodes
+ * allocated from 'resource' are copied into the current one, the rest are shared.
+ */
+Value copyOutOf(const Value& value, const std::pmr::memory_resource* resource);
+
 std::ostream& operator<<(std::ostream& os, const Scalar& val);
 std::ostream& operator<<(std::ostream& os, const Value& val);
 }  // namespace mqlpath
\ No newline at end of file
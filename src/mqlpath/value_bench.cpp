@@ -0,0 +1,123 @@
+#include "mqlpath/ast_eval.h"
+#include "mqlpath/ast_make.h"
+#include "mqlpath/value.h"
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <memory_resource>
+#include <string>
+
+namespace mqlpath {
+namespace {
+/**
+ * Builds a document with 'width' top-level fields, each holding a small nested object.
+ */
+Value makeDocument(size_t width) {
+    Object::Fields fields{};
+    fields.reserve(width);
+    for (size_t i = 0; i < width; ++i) {
+        Object nested{{
+            {"x", ast::value(static_cast<int32_t>(i))},
+            {"y", ast::value("value " + std::to_string(i))},
+            {"z", ast::value(std::vector<int32_t>{1, 2, 3})},
+        }};
+        fields.emplace_back("field" + std::to_string(i), ast::value(std::move(nested)));
+    }
+    return ast::value(Object{std::move(fields)});
+}
+}  // namespace
+
+TEST_CASE("Value copy cost by document size", "[value][benchmark]") {
+    for (size_t width : {10, 100, 1000, 10000}) {
+        auto document = makeDocument(width);
+        auto suffix = std::to_string(width) + " fields";
+
+        BENCHMARK("copy " + suffix) {
+            return Value{document};
+        };
+
+        BENCHMARK("copy and mutate " + suffix) {
+            Value copy{document};
+            copy.cast<ObjectValue>()->object.dropFields({"field0"});
+            return copy;
+        };
+
+        auto expr = ast::evalPath(ast::get("field0", ast::id()), document);
+        BENCHMARK("EvalPath Get " + suffix) {
+            return evaluate(expr);
+        };
+
+        auto dropExpr = ast::evalPath(ast::drop({"field0"}), document);
+        BENCHMARK("EvalPath Drop " + suffix) {
+            return evaluate(dropExpr);
+        };
+    }
+}
+
+TEST_CASE("Heap vs arena evaluation", "[value][benchmark]") {
+    for (size_t width : {10, 100, 1000}) {
+        Array array{};
+        for (size_t i = 0; i < width; ++i) {
+            array.emplace_back(makeDocument(10));
+        }
+        auto path = ast::traverse(ast::compose(ast::field("field0", ast::constPath(7)),
+                                               ast::drop({"field1", "field2"})));
+        auto expr = ast::evalPath(std::move(path), Value::make<ArrayValue>(std::move(array)));
+        auto suffix = std::to_string(width) + " documents";
+
+        BENCHMARK("heap Traverse " + suffix) {
+            return evaluate(expr);
+        };
+
+        BENCHMARK("arena Traverse " + suffix) {
+            return evaluate(expr, std::pmr::new_delete_resource());
+        };
+    }
+}
+
+TEST_CASE("Object field lookup by width", "[value][benchmark]") {
+    for (size_t width : {4, 8, 16, 32, 64, 256, 1024}) {
+        Object object{};
+        for (size_t i = 0; i < width; ++i) {
+            object.setValue("field" + std::to_string(i), ast::value(static_cast<int32_t>(i)));
+        }
+        FieldName lastField{"field" + std::to_string(width - 1)};
+        FieldName missingField{"missing"};
+        auto suffix = std::to_string(width) + " fields";
+
+        BENCHMARK("hasField last " + suffix) {
+            return object.hasField(lastField);
+        };
+
+        BENCHMARK("hasField missing " + suffix) {
+            return object.hasField(missingField);
+        };
+
+        std::vector<FieldName> kept{FieldName{"field0"}, lastField};
+        BENCHMARK("keepFields " + suffix) {
+            auto copy = object;
+            copy.keepFields(kept);
+            return copy;
+        };
+
+        auto value = ast::value(1);
+        BENCHMARK("copy and setValue last " + suffix) {
+            auto copy = object;
+            copy.setValue(lastField, value);
+            return copy;
+        };
+
+        BENCHMARK("getValue last " + suffix) {
+            return object.getValue(lastField);
+        };
+
+        BENCHMARK("getValue missing " + suffix) {
+            return object.getValue(missingField);
+        };
+
+        auto expr = ast::evalPath(ast::field(lastField, ast::constPath(1)), object);
+        BENCHMARK("EvalPath Field last " + suffix) {
+            return evaluate(expr);
+        };
+    }
+}
+}  // namespace mqlpath
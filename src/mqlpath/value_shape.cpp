@@ -0,0 +1,173 @@
+#include "mqlpath/value_shape.h"
+#include <ostream>
+#include <utility>
+
+namespace mqlpath {
+namespace {
+const ValueShape kAnyShape{};
+
+struct ShapeOf {
+    ValueShape operator()(const Value&, const NothingValue&) {
+        return ValueShape{ValueShape::kNothing};
+    }
+
+    ValueShape operator()(const Value&, const ScalarValue& scalar) {
+        static constexpr uint8_t kinds[] = {
+            ValueShape::kBool, ValueShape::kInt32, ValueShape::kDouble, ValueShape::kString};
+        return ValueShape{kinds[scalar.scalar.index()]};
+    }
+
+    ValueShape operator()(const Value&, const ArrayValue& array) {
+        ValueShape elements{0};
+        for (const auto& element : array.array) {
+            elements.unite(element.visit(*this));
+        }
+        ValueShape result{ValueShape::kArray};
+        result.setElements(std::move(elements));
+        return result;
+    }
+
+    ValueShape operator()(const Value&, const ObjectValue& object) {
+        const auto& names = object.object.getNames();
+        const auto& values = object.object.getValues();
+        ValueShape result{ValueShape::kObject};
+        result.setOtherFields(ValueShape{ValueShape::kNothing});
+        for (size_t position = 0; position < names.size(); ++position) {
+            result.setField(names[position], values[position].visit(*this));
+        }
+        return result;
+    }
+};
+}  // namespace
+
+ValueShape ValueShape::of(const Value& value) {
+    return value.visit(ShapeOf{});
+}
+
+const ValueShape& ValueShape::getField(const FieldName& fieldName) const {
+    const size_t position = findFieldName(_names.data(), _names.size(), fieldName);
+    return position != _names.size() ? _fields[position] : getOtherFields();
+}
+
+const ValueShape& ValueShape::getOtherFields() const {
+    return _otherFields != nullptr ? *_otherFields : kAnyShape;
+}
+
+const ValueShape& ValueShape::getElements() const {
+    return _elements != nullptr ? *_elements : kAnyShape;
+}
+
+void ValueShape::setField(const FieldName& fieldName, ValueShape shape) {
+    const size_t position = findFieldName(_names.data(), _names.size(), fieldName);
+    if (position != _names.size()) {
+        _fields[position] = std::move(shape);
+    } else {
+        _names.push_back(fieldName);
+        _fields.emplace_back(std::move(shape));
+    }
+}
+
+void ValueShape::setOtherFields(ValueShape shape) {
+    _otherFields = shape.isAny() ? nullptr : std::make_shared<const ValueShape>(std::move(shape));
+}
+
+void ValueShape::setElements(ValueShape shape) {
+    _elements = shape.isAny() ? nullptr : std::make_shared<const ValueShape>(std::move(shape));
+}
+
+bool ValueShape::isAny() const {
+    return _kinds == kAny && _names.empty() && _otherFields == nullptr && _elements == nullptr;
+}
+
+void ValueShape::unite(const ValueShape& other) {
+    if (isAny() || other.isAny()) {
+        *this = ValueShape{};
+        return;
+    }
+    // The fields and elements of a shape only describe its objects and arrays, so those of a
+    // shape without objects or arrays are left out.
+    if (other.mayBe(kObject)) {
+        if (!mayBe(kObject)) {
+            _names = other._names;
+            _fields = other._fields;
+            _otherFields = other._otherFields;
+        } else {
+            auto names = _names;
+            for (const auto& fieldName : other._names) {
+                if (findFieldName(names.data(), names.size(), fieldName) == names.size()) {
+                    names.push_back(fieldName);
+                }
+            }
+            std::vector<ValueShape> fields{};
+            fields.reserve(names.size());
+            for (const auto& fieldName : names) {
+                fields.emplace_back(getField(fieldName));
+                fields.back().unite(other.getField(fieldName));
+            }
+            auto otherFields = getOtherFields();
+            otherFields.unite(other.getOtherFields());
+
+            _names = std::move(names);
+            _fields = std::move(fields);
+            setOtherFields(std::move(otherFields));
+        }
+    }
+
+    if (other.mayBe(kArray)) {
+        if (!mayBe(kArray)) {
+            _elements = other._elements;
+        } else if (_elements != nullptr) {
+            auto elements = *_elements;
+            elements.unite(other.getElements());
+            setElements(std::move(elements));
+        }
+    }
+
+    _kinds |= other._kinds;
+}
+
+std::ostream& operator<<(std::ostream& os, const ValueShape& shape) {
+    static constexpr std::pair<uint8_t, const char*> kinds[] = {
+        {ValueShape::kNothing, "nothing"},
+        {ValueShape::kBool, "bool"},
+        {ValueShape::kInt32, "int32"},
+        {ValueShape::kDouble, "double"},
+        {ValueShape::kString, "string"},
+        {ValueShape::kArray, "array"},
+        {ValueShape::kObject, "object"},
+    };
+
+    if (shape._kinds == 0) {
+        return os << "none";
+    }
+    if (shape.isAny()) {
+        return os << "any";
+    }
+    const char* separator = "";
+    for (const auto& [kind, name] : kinds) {
+        if (!shape.mayBe(kind)) {
+            continue;
+        }
+        os << separator << name;
+        separator = "|";
+
+        if (kind == ValueShape::kArray && shape._elements != nullptr) {
+            os << "[" << *shape._elements << "]";
+        }
+        if (kind == ValueShape::kObject &&
+            (!shape._names.empty() || shape._otherFields != nullptr)) {
+            os << "{";
+            const char* fieldSeparator = "";
+            for (size_t position = 0; position < shape._names.size(); ++position) {
+                os << fieldSeparator << shape._names[position] << ": " << shape._fields[position];
+                fieldSeparator = ", ";
+            }
+            if (shape._otherFields != nullptr) {
+                os << fieldSeparator << "*: " << *shape._otherFields;
+            }
+            os << "}";
+        }
+    }
+    return os;
+}
+}  // namespace mqlpath
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "mqlpath/field_name.h"
+#include "mqlpath/value.h"
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <vector>
+
+namespace mqlpath {
+/**
+ * Abstract description of a set of values: the kinds a value may have and, for objects and
+ * arrays, the shapes of their fields and elements. A missing field is Nothing, so the shape of a
+ * field which may be missing includes kNothing. Unless set, fields and elements may be anything.
+ * The shape without any kind describes no value at all, e.g. the elements of empty arrays.
+ */
+class ValueShape {
+public:
+    enum Kind : uint8_t {
+        kNothing = 1,
+        kBool = 2,
+        kInt32 = 4,
+        kDouble = 8,
+        kString = 16,
+        kArray = 32,
+        kObject = 64,
+    };
+
+    static constexpr uint8_t kScalar = kBool | kInt32 | kDouble | kString;
+    static constexpr uint8_t kAny = kNothing | kScalar | kArray | kObject;
+
+    /**
+     * Values of any kind.
+     */
+    ValueShape() = default;
+
+    explicit ValueShape(uint8_t kinds) : _kinds(kinds) {}
+
+    /**
+     * The shape of exactly this value: its fields are those of the value, all others are missing.
+     */
+    static ValueShape of(const Value& value);
+
+    uint8_t getKinds() const {
+        return _kinds;
+    }
+
+    /**
+     * Whether a value of the shape may be of one of the kinds.
+     */
+    bool mayBe(uint8_t kinds) const {
+        return (_kinds & kinds) != 0;
+    }
+
+    /**
+     * Whether every value of the shape is of one of the kinds.
+     */
+    bool isOnly(uint8_t kinds) const {
+        return (_kinds & ~kinds) == 0;
+    }
+
+    /**
+     * The shape of the field of an object.
+     */
+    const ValueShape& getField(const FieldName& fieldName) const;
+
+    /**
+     * The fields whose shapes were set, in the order they were first set.
+     */
+    const std::vector<FieldName>& getFieldNames() const {
+        return _names;
+    }
+
+    /**
+     * The shape of the fields of an object which were not set.
+     */
+    const ValueShape& getOtherFields() const;
+
+    /**
+     * The shape of every element of an array.
+     */
+    const ValueShape& getElements() const;
+
+    void setField(const FieldName& fieldName, ValueShape shape);
+
+    void setOtherFields(ValueShape shape);
+
+    void setElements(ValueShape shape);
+
+    /**
+     * Leaves out the values which are not of one of the kinds.
+     */
+    void restrict(uint8_t kinds) {
+        _kinds &= kinds;
+    }
+
+    /**
+     * Adds the values of 'other' to this shape.
+     */
+    void unite(const ValueShape& other);
+
+    friend std::ostream& operator<<(std::ostream& os, const ValueShape& shape);
+
+private:
+    /**
+     * Whether this is the shape of any value, without anything known about fields or elements.
+     */
+    bool isAny() const;
+
+    uint8_t _kinds{kAny};
+    // The fields whose shapes were set, which apply to the objects of the shape.
+    std::vector<FieldName> _names;
+    std::vector<ValueShape> _fields;
+    // Shared as shapes are copied while they are inferred; null for any value.
+    std::shared_ptr<const ValueShape> _otherFields;
+    std::shared_ptr<const ValueShape> _elements;
+};
+}  // namespace mqlpath
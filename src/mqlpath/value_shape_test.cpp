@@ -0,0 +1,61 @@
+#include "mqlpath/ast_make.h"
+#include "mqlpath/value_shape.h"
+#include <catch2/catch_test_macros.hpp>
+#include <sstream>
+
+namespace mqlpath {
+namespace {
+std::string toString(const ValueShape& shape) {
+    std::ostringstream os;
+    os << shape;
+    return os.str();
+}
+}  // namespace
+
+TEST_CASE("shapes of values", "[value_shape]") {
+    REQUIRE(toString(ValueShape{}) == "any");
+    REQUIRE(toString(ValueShape{0}) == "none");
+    REQUIRE(toString(ValueShape::of(ast::nothing())) == "nothing");
+    REQUIRE(toString(ValueShape::of(ast::value(true))) == "bool");
+    REQUIRE(toString(ValueShape::of(ast::value(1))) == "int32");
+    REQUIRE(toString(ValueShape::of(ast::value(1.5))) == "double");
+    REQUIRE(toString(ValueShape::of(ast::value("a"))) == "string");
+    REQUIRE(toString(ValueShape::of(ast::value(std::vector<int32_t>{}))) == "array[none]");
+
+    auto document = ast::value(Object{{
+        {"a", Value::make<ArrayValue>(std::vector<Value>{ast::value(1), ast::value("b")})},
+        {"c", ast::value(Object{})},
+    }});
+    auto shape = ValueShape::of(document);
+    REQUIRE(toString(shape) == "object{a: array[int32|string], c: object{*: nothing}, *: nothing}");
+    REQUIRE(shape.isOnly(ValueShape::kObject));
+    REQUIRE(shape.getField("c").mayBe(ValueShape::kObject));
+    REQUIRE(shape.getField("d").isOnly(ValueShape::kNothing));
+    REQUIRE(shape.getElements().getKinds() == ValueShape::kAny);
+}
+
+TEST_CASE("united shapes describe the values of both", "[value_shape]") {
+    auto shape = ValueShape::of(ast::value(Object{{{"a", ast::value(1)}}}));
+    shape.unite(ValueShape::of(ast::value(Object{{{"b", ast::value(true)}}})));
+    REQUIRE(toString(shape) ==
+            "object{a: nothing|int32, b: nothing|bool, *: nothing}");
+
+    // The fields of other kinds are left out.
+    auto scalars = ValueShape{ValueShape::kScalar};
+    scalars.setField("a", ValueShape{0});
+    scalars.unite(shape);
+    REQUIRE(toString(scalars) ==
+            "bool|int32|double|string|object{a: nothing|int32, b: nothing|bool, *: nothing}");
+
+    auto arrays = ValueShape::of(ast::value(std::vector<int32_t>{}));
+    arrays.unite(ValueShape::of(ast::value(std::vector<int32_t>{1})));
+    arrays.unite(ValueShape{ValueShape::kNothing});
+    REQUIRE(toString(arrays) == "nothing|array[int32]");
+    arrays.unite(ValueShape{});
+    REQUIRE(toString(arrays) == "any");
+
+    auto unknown = ValueShape{ValueShape::kObject};
+    unknown.unite(shape);
+    REQUIRE(toString(unknown) == "object{a: any, b: any}");
+}
+}  // namespace mqlpath
@@ -0,0 +1,171 @@
+#include "mqlpath/ast_eval.h"
+#include "mqlpath/ast_make.h"
+#include "mqlpath/value.h"
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <utility>
+
+namespace mqlpath {
+TEST_CASE("copied value shares the payload", "[value]") {
+    Value value = ast::value(Object{{{"a", ast::value(1)}, {"b", ast::value("foo")}}});
+    REQUIRE(!value.isShared());
+
+    Value copy = value;
+    REQUIRE(value.isShared());
+    REQUIRE(copy.isShared());
+    REQUIRE(std::as_const(value).cast<ObjectValue>() == std::as_const(copy).cast<ObjectValue>());
+}
+
+TEST_CASE("const access does not clone a shared value", "[value]") {
+    Value value = ast::value(Object{{{"a", ast::value(1)}}});
+    Value copy = value;
+
+    const Value& constCopy = copy;
+    REQUIRE(constCopy.cast<ObjectValue>() == std::as_const(value).cast<ObjectValue>());
+    REQUIRE(copy.isShared());
+}
+
+TEST_CASE("mutable access clones a shared value", "[value]") {
+    Value value = ast::value(Object{{{"a", ast::value(1)}, {"b", ast::value(2)}}});
+    Value copy = value;
+
+    copy.cast<ObjectValue>()->object.dropFields({"a"});
+
+    REQUIRE(!value.isShared());
+    REQUIRE(!copy.isShared());
+    REQUIRE(ast::value(Object{{{"a", ast::value(1)}, {"b", ast::value(2)}}}) == value);
+    REQUIRE(ast::value(Object{{{"b", ast::value(2)}}}) == copy);
+}
+
+TEST_CASE("mutable access does not clone a unique value", "[value]") {
+    Value value = ast::value(Object{{{"a", ast::value(1)}}});
+    const ObjectValue* before = std::as_const(value).cast<ObjectValue>();
+    REQUIRE(value.cast<ObjectValue>() == before);
+}
+
+TEST_CASE("evaluation does not modify the constant document", "[value]") {
+    Object object{{{"a", ast::value(7)}, {"b", ast::value(9)}}};
+    auto expr = ast::evalPath(ast::drop({"a"}), object);
+
+    REQUIRE(ast::value(Object{{{"b", ast::value(9)}}}) == evaluate(expr));
+    REQUIRE(ast::value(Object{{{"b", ast::value(9)}}}) == evaluate(expr));
+    REQUIRE(ast::evalPath(ast::drop({"a"}), object) == expr);
+}
+
+namespace {
+Object makeWideObject(int32_t width) {
+    Object object{};
+    for (int32_t i = 0; i < width; ++i) {
+        object.setValue("f" + std::to_string(i), ast::value(i));
+    }
+    return object;
+}
+}  // namespace
+
+TEST_CASE("wide object looks up every field", "[value]") {
+    const int32_t width = 200;
+    auto object = makeWideObject(width);
+
+    for (int32_t i = 0; i < width; ++i) {
+        REQUIRE(object.hasField("f" + std::to_string(i)));
+        REQUIRE(ast::value(i) == object.getValue("f" + std::to_string(i)));
+    }
+    REQUIRE(!object.hasField("f200"));
+    REQUIRE(isNothing(object.getValue("missing")));
+}
+
+TEST_CASE("wide object keeps insertion order", "[value]") {
+    auto object = makeWideObject(100);
+    object.setValue("f50", ast::value("updated"));
+    object.setValue("last", ast::value(true));
+
+    const auto& names = object.getNames();
+    REQUIRE(object.size() == 101);
+    REQUIRE(names[0] == "f0");
+    REQUIRE(names[50] == "f50");
+    REQUIRE(ast::value("updated") == object.getValues()[50]);
+    REQUIRE(names[100] == "last");
+}
+
+TEST_CASE("objects are copied, moved and assigned with their fields", "[value]") {
+    for (size_t width : {0, 3, 40}) {
+        auto object = makeWideObject(width);
+        Object copy{object};
+        copy.setValue("x", ast::value(true));
+        REQUIRE(copy.size() == width + 1);
+        REQUIRE(object.size() == width);
+        REQUIRE(!object.hasField("x"));
+
+        Object moved{std::move(copy)};
+        REQUIRE(moved.hasField("x"));
+        REQUIRE(copy.size() == 0);
+        REQUIRE(!copy.hasField("x"));
+
+        Object assigned = makeWideObject(5);
+        assigned = moved;
+        REQUIRE(assigned == moved);
+        assigned = makeWideObject(50);
+        REQUIRE(assigned == makeWideObject(50));
+        REQUIRE(assigned.hasField("f49"));
+        assigned = std::move(moved);
+        REQUIRE(assigned.size() == width + 1);
+        REQUIRE(assigned.hasField("x"));
+    }
+}
+
+TEST_CASE("wide object drops and keeps fields", "[value]") {
+    auto object = makeWideObject(100);
+    object.dropFields({"f0", "f10", "f99"});
+    REQUIRE(object.size() == 97);
+    REQUIRE(!object.hasField("f10"));
+    REQUIRE(ast::value(11) == object.getValue("f11"));
+    REQUIRE(object.getNames()[0] == "f1");
+
+    object.setValue("f11", ast::nothing());
+    REQUIRE(!object.hasField("f11"));
+    REQUIRE(ast::value(12) == object.getValue("f12"));
+
+    object.keepFields({"f5", "f12", "f98"});
+    REQUIRE(object.size() == 3);
+    REQUIRE(ast::value(98) == object.getValue("f98"));
+    REQUIRE(!object.hasField("f13"));
+
+    object.setValue("f13", ast::value(13));
+    REQUIRE(ast::value(13) == object.getValue("f13"));
+}
+
+TEST_CASE("wide objects compare by fields", "[value]") {
+    auto object = makeWideObject(20);
+    auto other = makeWideObject(30);
+    REQUIRE(!(object == other));
+
+    other.keepFields({"f0", "f1", "f2", "f3", "f4", "f5", "f6", "f7", "f8", "f9",
+                      "f10", "f11", "f12", "f13", "f14", "f15", "f16", "f17", "f18", "f19"});
+    REQUIRE(object == other);
+}
+
+TEST_CASE("released fields are restored in place", "[value]") {
+    for (size_t width : {4, 40}) {
+        auto object = makeWideObject(width);
+        size_t position = Object::npos;
+        auto value = object.releaseValue("f2", position);
+        REQUIRE(ast::value(2) == value);
+        object.restoreValue("f2", position, ast::value(20));
+        REQUIRE(ast::value(20) == object.getValue("f2"));
+        REQUIRE(object.getNames()[2] == "f2");
+
+        value = object.releaseValue("x", position);
+        REQUIRE(position == Object::npos);
+        REQUIRE(isNothing(value));
+        object.restoreValue("x", position, ast::value(7));
+        REQUIRE(object.getNames().back() == "x");
+        REQUIRE(ast::value(7) == object.getValue("x"));
+
+        object.releaseValue("f1", position);
+        object.restoreValue("f1", position, ast::nothing());
+        REQUIRE(!object.hasField("f1"));
+        REQUIRE(object.size() == width);
+        REQUIRE(ast::value(3) == object.getValue("f3"));
+    }
+}
+}  // namespace mqlpath
@@ -0,0 +1,119 @@
+#include "mqlpath/work_stealing_pool.h"
+#include <algorithm>
+#include <utility>
+
+namespace mqlpath {
+WorkStealingPool::WorkStealingPool(size_t workerCount) {
+    workerCount = std::max<size_t>(workerCount, 1);
+    for (size_t worker = 0; worker < workerCount; ++worker) {
+        _queues.emplace_back(std::make_unique<Queue>());
+    }
+    for (size_t worker = 1; worker < workerCount; ++worker) {
+        _threads.emplace_back([this, worker] { workerLoop(worker); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard lock{_mutex};
+        _stopping = true;
+    }
+    _wakeUp.notify_all();
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::parallelFor(size_t taskCount, const Task& task) {
+    if (taskCount == 0) {
+        return;
+    }
+
+    std::lock_guard callLock{_callMutex};
+    {
+        std::lock_guard lock{_mutex};
+        _task = &task;
+        _pendingTasks = taskCount;
+        _error = nullptr;
+        // Contiguous ranges keep neighbouring tasks on one worker until stealing kicks in.
+        const size_t workerCount = _queues.size();
+        for (size_t worker = 0; worker < workerCount; ++worker) {
+            auto& queue = *_queues[worker];
+            std::lock_guard queueLock{queue.mutex};
+            const size_t first = taskCount * worker / workerCount;
+            const size_t last = taskCount * (worker + 1) / workerCount;
+            // Owners pop from the back, so push in reverse to run their range in order.
+            for (size_t index = last; index-- > first;) {
+                queue.tasks.push_back(index);
+            }
+        }
+        ++_generation;
+    }
+    _wakeUp.notify_all();
+
+    while (runTask(0)) {
+    }
+
+    std::unique_lock lock{_mutex};
+    _finished.wait(lock, [this] { return _pendingTasks == 0; });
+    _task = nullptr;
+    if (_error) {
+        std::rethrow_exception(std::exchange(_error, nullptr));
+    }
+}
+
+void WorkStealingPool::workerLoop(size_t worker) {
+    size_t generation = 0;
+    while (true) {
+        {
+            std::unique_lock lock{_mutex};
+            _wakeUp.wait(lock, [&] { return _stopping || _generation != generation; });
+            if (_stopping) {
+                return;
+            }
+            generation = _generation;
+        }
+
+        while (runTask(worker)) {
+        }
+    }
+}
+
+bool WorkStealingPool::runTask(size_t worker) {
+    const size_t workerCount = _queues.size();
+    for (size_t offset = 0; offset < workerCount; ++offset) {
+        auto& queue = *_queues[(worker + offset) % workerCount];
+        size_t index;
+        {
+            std::lock_guard queueLock{queue.mutex};
+            if (queue.tasks.empty()) {
+                continue;
+            }
+            if (offset == 0) {
+                index = queue.tasks.back();
+                queue.tasks.pop_back();
+            } else {
+                index = queue.tasks.front();
+                queue.tasks.pop_front();
+            }
+        }
+
+        std::exception_ptr error;
+        try {
+            (*_task)(index, worker);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        std::lock_guard lock{_mutex};
+        if (error && !_error) {
+            _error = error;
+        }
+        if (--_pendingTasks == 0) {
+            _finished.notify_all();
+        }
+        return true;
+    }
+    return false;
+}
+}  // namespace mqlpath
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mqlpath {
+/**
+ * Fixed set of workers running the tasks of one parallelFor() at a time. Every worker owns a
+ * queue of task indices: it takes tasks from the back of its own queue and, once that is empty,
+ * steals from the front of the others', so uneven tasks are balanced without a shared queue. The
+ * thread calling parallelFor() takes part as worker 0.
+ */
+class WorkStealingPool {
+public:
+    using Task = std::function<void(size_t task, size_t worker)>;
+
+    explicit WorkStealingPool(size_t workerCount = std::thread::hardware_concurrency());
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /**
+     * Runs 'task' for every index in [0, taskCount) and returns once all of them finished. The
+     * task also receives the index of the worker running it, which is below getWorkerCount() and
+     * may be used to address per-worker state. The first exception thrown by a task is rethrown
+     * after the remaining tasks completed.
+     */
+    void parallelFor(size_t taskCount, const Task& task);
+
+    size_t getWorkerCount() const {
+        return _queues.size();
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    void workerLoop(size_t worker);
+
+    /**
+     * Runs one task of the current parallelFor(), either from the worker's own queue or stolen
+     * from another one. Returns false when all queues are empty.
+     */
+    bool runTask(size_t worker);
+
+    std::vector<std::unique_ptr<Queue>> _queues;
+    std::vector<std::thread> _threads;
+
+    // Serializes concurrent parallelFor() calls.
+    std::mutex _callMutex;
+
+    std::mutex _mutex;
+    std::condition_variable _wakeUp;
+    std::condition_variable _finished;
+    const Task* _task{nullptr};
+    size_t _generation{0};
+    size_t _pendingTasks{0};
+    std::exception_ptr _error;
+    bool _stopping{false};
+};
+}  // namespace mqlpath
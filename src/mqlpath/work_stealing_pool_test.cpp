@@ -0,0 +1,46 @@
+#include "mqlpath/work_stealing_pool.h"
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <stdexcept>
+
+namespace mqlpath {
+TEST_CASE("parallelFor runs every task exactly once", "[pool]") {
+    WorkStealingPool pool{4};
+    REQUIRE(pool.getWorkerCount() == 4);
+
+    for (size_t taskCount : {0, 1, 3, 1000}) {
+        std::vector<std::atomic<int>> runs(taskCount);
+        std::atomic<bool> validWorkers{true};
+        pool.parallelFor(taskCount, [&](size_t task, size_t worker) {
+            runs[task].fetch_add(1);
+            if (worker >= pool.getWorkerCount()) {
+                validWorkers = false;
+            }
+        });
+
+        REQUIRE(validWorkers);
+        for (const auto& count : runs) {
+            REQUIRE(count == 1);
+        }
+    }
+}
+
+TEST_CASE("parallelFor rethrows task errors", "[pool]") {
+    WorkStealingPool pool{3};
+    std::atomic<int> runs{0};
+    REQUIRE_THROWS_AS(pool.parallelFor(100,
+                                       [&](size_t task, size_t) {
+                                           ++runs;
+                                           if (task == 42) {
+                                               throw std::runtime_error("task failed");
+                                           }
+                                       }),
+                      std::runtime_error);
+    REQUIRE(runs == 100);
+
+    // The pool stays usable.
+    runs = 0;
+    pool.parallelFor(10, [&](size_t, size_t) { ++runs; });
+    REQUIRE(runs == 10);
+}
+}  // namespace mqlpath
@@ -30,6 +30,9 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <memory_resource>
+#include <new>
 #include <stdexcept>
 #include <type_traits>
 #include <cassert>
@@ -80,24 +83,83 @@ struct get_type_by_index_impl<0, T, Ts...> {
 template <int I, typename... Ts>
 using get_type_by_index = typename get_type_by_index_impl<I, Ts...>::type;
 
+inline std::pmr::memory_resource*& threadMemoryResource() noexcept {
+    thread_local std::pmr::memory_resource* resource = std::pmr::new_delete_resource();
+    return resource;
+}
+
 }  // namespace detail
 
+/**
+ * Returns the memory resource that new control blocks are allocated from on the calling thread.
+ * It is the global new/delete resource unless a MemoryResourceScope is active.
+ */
+inline std::pmr::memory_resource* currentMemoryResource() noexcept {
+    return detail::threadMemoryResource();
+}
+
+/**
+ * Redirects control block allocations on the calling thread to the given resource for the
+ * lifetime of the scope. Each block remembers its resource, so it is safe to release blocks after
+ * the scope is closed as long as the resource itself is still alive.
+ */
+class MemoryResourceScope {
+public:
+    explicit MemoryResourceScope(std::pmr::memory_resource* resource) noexcept
+        : _previous(detail::threadMemoryResource()) {
+        detail::threadMemoryResource() = resource;
+    }
+
+    MemoryResourceScope(const MemoryResourceScope&) = delete;
+    MemoryResourceScope& operator=(const MemoryResourceScope&) = delete;
+
+    ~MemoryResourceScope() noexcept {
+        detail::threadMemoryResource() = _previous;
+    }
+
+private:
+    std::pmr::memory_resource* _previous;
+};
+
 /**
  * The base control block that PolyValue holds.
  *
- * It does not contain anything else except for the runtime tag.
+ * It contains the runtime tag, the number of PolyValues sharing the block and the memory resource
+ * the block was allocated from.
  */
 template <typename... Ts>
 class ControlBlock {
     const int _tag;
+    mutable std::atomic<int> _refCount{1};
+    std::pmr::memory_resource* const _resource;
 
 protected:
-    ControlBlock(int tag) noexcept : _tag(tag) {}
+    ControlBlock(int tag, std::pmr::memory_resource* resource) noexcept
+        : _tag(tag), _resource(resource) {}
 
 public:
     auto getRuntimeTag() const noexcept {
         return _tag;
     }
+
+    std::pmr::memory_resource* getResource() const noexcept {
+        return _resource;
+    }
+
+    void addRef() const noexcept {
+        _refCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Drops one reference and returns true if it was the last one.
+     */
+    bool release() const noexcept {
+        return _refCount.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    }
+
+    bool isShared() const noexcept {
+        return _refCount.load(std::memory_order_acquire) > 1;
+    }
 };
 
 /**
@@ -122,7 +184,8 @@ protected:
 
     public:
         template <typename... Args>
-        ConcreteType(Args&&... args) : AbstractType(_staticTag), _t(std::forward<Args>(args)...) {}
+        ConcreteType(std::pmr::memory_resource* resource, Args&&... args)
+            : AbstractType(_staticTag, resource), _t(std::forward<Args>(args)...) {}
 
         const T* getPtr() const noexcept {
             return &_t;
@@ -144,15 +207,25 @@ protected:
 public:
     template <typename... Args>
     static AbstractType* make(Args&&... args) {
-        return new ConcreteType(std::forward<Args>(args)...);
+        auto resource = currentMemoryResource();
+        void* ptr = resource->allocate(sizeof(ConcreteType), alignof(ConcreteType));
+        try {
+            return new (ptr) ConcreteType(resource, std::forward<Args>(args)...);
+        } catch (...) {
+            resource->deallocate(ptr, sizeof(ConcreteType), alignof(ConcreteType));
+            throw;
+        }
     }
 
     static AbstractType* clone(const AbstractType* block) {
-        return new ConcreteType(*concrete(block));
+        return make(*concrete(block)->getPtr());
     }
 
     static void destroy(AbstractType* block) noexcept {
-        delete concrete(block);
+        auto resource = block->getResource();
+        auto ptr = concrete(block);
+        ptr->~ConcreteType();
+        resource->deallocate(ptr, sizeof(ConcreteType), alignof(ConcreteType));
     }
 
     static bool compareEq(AbstractType* blockLhs, AbstractType* blockRhs) noexcept {
@@ -210,10 +283,16 @@ public:
  * Supported operations:
  * - construction
  * - destruction
- * - clone a = b;
+ * - copy a = b; (shares the control block, see below)
  * - cast a.cast<T>()
  * - multi-method cast to common base a.cast<B>()
  * - multi-method visit
+ *
+ * Copies are copy-on-write: they share the control block through an atomic reference count and
+ * the payload is cloned only when a shared value is accessed through a non-const cast() or visit().
+ * Since the payload's own PolyValue members are shared in turn, the clone is shallow. Reading
+ * through a const PolyValue never clones, so prefer const access when no mutation is needed.
+ * Reference is a non-owning handle and does not take part in copy-on-write.
  */
 template <typename... Ts>
 class PolyValue : private ControlBlockVTable<Ts, Ts...>... {
@@ -246,6 +325,24 @@ private:
         destroyTbl[object->getRuntimeTag()](object);
     }
 
+    static void release(ControlBlock<Ts...>* object) noexcept {
+        if (object->release()) {
+            destroy(object);
+        }
+    }
+
+    /**
+     * Makes this PolyValue the only owner of its control block, cloning the payload if it is
+     * shared.
+     */
+    void detach() {
+        if (_object && _object->isShared()) {
+            auto object = cloneTbl[tag()](_object);
+            release(_object);
+            _object = object;
+        }
+    }
+
     template <typename T>
     static T* cast(ControlBlock<Ts...>* object) {
         check(object);
@@ -399,13 +496,15 @@ public:
 
     PolyValue(const PolyValue& other) {
         if (other._object) {
-            _object = cloneTbl[other.tag()](other._object);
+            other._object->addRef();
+            _object = other._object;
         }
     }
 
     PolyValue(const Reference& other) {
         if (other._object) {
-            _object = cloneTbl[other.tag()](other._object);
+            other._object->addRef();
+            _object = other._object;
         }
     }
 
@@ -415,7 +514,7 @@ public:
 
     ~PolyValue() noexcept {
         if (_object) {
-            destroy(_object);
+            release(_object);
         }
     }
 
@@ -444,6 +543,7 @@ public:
             &ControlBlockVTable<Ts, Ts...>::template visit<Callback, PolyValue, Args...>...};
 
         check(_object);
+        detach();
         return visitTbl[tag()](
             std::forward<Callback>(cb), *this, _object, std::forward<Args>(args)...);
     }
@@ -467,6 +567,7 @@ public:
 
     template <typename T>
     T* cast() {
+        detach();
         return cast<T>(_object);
     }
 
@@ -484,6 +585,21 @@ public:
         return !_object;
     }
 
+    /**
+     * Returns true if other PolyValues share the control block with this one.
+     */
+    bool isShared() const noexcept {
+        return _object && _object->isShared();
+    }
+
+    /**
+     * Returns the memory resource the control block was allocated from.
+     */
+    std::pmr::memory_resource* getResource() const {
+        check(_object);
+        return _object->getResource();
+    }
+
     void swap(PolyValue& other) noexcept {
         std::swap(other._object, _object);
     }